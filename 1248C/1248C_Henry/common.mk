@@ -55,6 +55,12 @@ SIZETOOL:=$(ARCHTUPLE)size
 READELF:=$(ARCHTUPLE)readelf
 STRIP:=$(ARCHTUPLE)strip
 
+ifeq ($(USE_LTO),1)
+GCCFLAGS+=-flto=auto -ffat-lto-objects
+# gcc-ar loads the LTO plugin so library archives get a usable symbol index
+AR:=$(ARCHTUPLE)gcc-ar
+endif
+
 ifneq (, $(shell command -v gnumfmt 2> /dev/null))
 	SIZES_NUMFMT:=| gnumfmt --field=-4 --header $(NUMFMTFLAGS)
 else
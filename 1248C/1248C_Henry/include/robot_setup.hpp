@@ -0,0 +1,38 @@
+/**
+ * \file robot_setup.hpp
+ *
+ * This robot's ports, reversals, cartridges and drivetrain measurements.
+ *
+ * robotcore's robot.hpp includes this to build the devices, so each program
+ * using robot.hpp has its own copy next to its main.h. See
+ * robotcore/robot_config.hpp for what each field means.
+ */
+
+#ifndef _ROBOT_SETUP_HPP_
+#define _ROBOT_SETUP_HPP_
+
+#include "robotcore/robot_config.hpp"
+
+// Henry has no block sensor, camera or radio. The drivetrain measurements
+// have not been taken on this robot; nothing in this program uses them yet.
+inline constexpr RobotConfig robot_config = {
+	.left_drive = {-16, 18, 17},
+	.right_drive = {-13, -14, 12},
+	.conveyor = 20,
+	.top_roller = 11,
+	.block_sensor = 0,
+	.block_camera = 0,
+	.radio = 0,
+	.link_transmitter = false,
+	.descorer = 'G',
+	.match_loader = 'H',
+	.drive_gear = pros::MotorGear::green,
+	.conveyor_gear = pros::MotorGear::green,
+	.top_roller_gear = pros::MotorGear::green,
+	.drive_measured = false,
+	.drive_ratio = 1.0,
+	.wheel_diameter_in = 4.0,
+	.track_width_in = 12.0,
+};
+
+#endif  // _ROBOT_SETUP_HPP_
@@ -1,31 +1,11 @@
 #include "main.h"
-
-// Conveyor and top roller motors
-inline pros::Motor conveyor(20, pros::v5::MotorGear::green);
-inline pros::Motor top_roller(11, pros::v5::MotorGear::green);
-
-// Conveyor control macros
-#define conveyor_on() conveyor.move(120)
-#define conveyor_off() conveyor.move(0)
-#define conveyor_reverse() conveyor.move(-120)
-
-// Top roller control macros
-#define top_roller_on() top_roller.move(-120)
-#define top_roller_off() top_roller.move(0)
-#define top_roller_reverse() top_roller.move(90)
-
-// Match loader solenoids (ports G and H)
-pros::ADIDigitalOut descorer('G');
-pros::ADIDigitalOut match_loader_solenoid('H');
-
-// Turn both on
-#define intake_on() do { conveyor_on(); top_roller_on(); } while(0)
-
-// Store match loads (conveyor on, top roller in reverse at half speed)
-#define store_match_load() do { conveyor.move(120); top_roller.move(55); } while(0)
+#include "robotcore/robot.hpp"
+#include "robotcore/heap_guard.hpp"
 
 // A simple autonomous function that drives forward for a short time
 void dummy_auto() {
+	// These are the groups this routine has always used, not the opcontrol
+	// drive in robot_setup.hpp.
 	pros::MotorGroup left_mg({19, 18, -17});
 	pros::MotorGroup right_mg({-13, 14, -12});
 
@@ -69,6 +49,8 @@ void initialize() {
 	pros::lcd::set_text(1, "Rayed FTW");
 
 	pros::lcd::register_btn1_cb(on_center_button);
+
+	heap_guard::seal();  // Nothing allocates from here on
 }
 
 /**
@@ -120,8 +102,6 @@ void autonomous() {
 void opcontrol() {
 	
 	pros::Controller master(pros::E_CONTROLLER_MASTER);
-	pros::MotorGroup left_mg({-16, 18, 17});    // Creates a motor group with forwards ports 1 & 3 and reversed port 2
-	pros::MotorGroup right_mg({-13, -14, 12});  // Creates a motor group with forwards port 5 and reversed ports 4 & 6
 
 	// State variables for toggles
 	bool conveyor_enabled = false;
@@ -82,8 +82,10 @@ typedef int16_t lv_coord_t;
 /* 1: use custom malloc/free, 0: use the built-in `lv_mem_alloc` and `lv_mem_free` */
 #define LV_MEM_CUSTOM      0
 #if LV_MEM_CUSTOM == 0
-/* Size of the memory used by `lv_mem_alloc` in bytes (>= 2kB)*/
-#  define LV_MEM_SIZE    (10U * 1024U * 1024U)
+/* Size of the memory used by `lv_mem_alloc` in bytes (>= 2kB). `make LVGL_HEAP_KB=...` overrides it */
+#  ifndef LV_MEM_SIZE
+#    define LV_MEM_SIZE    (10U * 1024U * 1024U)
+#  endif
 
 /* Compiler prefix for a big array declaration */
 #  define LV_MEM_ATTR
@@ -0,0 +1,48 @@
+/**
+ * \file robot_setup.hpp
+ *
+ * This robot's ports, reversals, cartridges and drivetrain measurements.
+ *
+ * robotcore's robot.hpp includes this to build the devices, so each program
+ * using robot.hpp has its own copy next to its main.h. See
+ * robotcore/robot_config.hpp for what each field means.
+ */
+
+#ifndef _ROBOT_SETUP_HPP_
+#define _ROBOT_SETUP_HPP_
+
+#include "robotcore/robot_config.hpp"
+
+inline constexpr RobotConfig robot_config = {
+	.left_drive = {16, 18, 17},
+	.right_drive = {13, 14, 12},
+	.conveyor = 20,
+	.top_roller = 11,
+	.block_sensor = 1,
+	.block_camera = 2,
+	.radio = 3,
+	.link_transmitter = true,
+	.descorer = 'G',
+	.match_loader = 'H',
+	.drive_gear = pros::MotorGear::blue,  // placeholder, see below
+	.conveyor_gear = pros::MotorGear::green,
+	.top_roller_gear = pros::MotorGear::green,
+	// Placeholders, not measured on this robot: the drive cartridge above and
+	// the ratio, wheel and track width here. Check the cartridges, count the
+	// gear teeth, measure the wheels and the wheel-center track, then set
+	// drive_measured. Until then the drive motors keep their own cartridge
+	// setting, and settle, power_budget and tools/skills_planner only have
+	// these guesses to work from.
+	.drive_measured = false,
+	.drive_ratio = 36.0 / 48.0,
+	.wheel_diameter_in = 3.25,
+	.track_width_in = 11.5,
+};
+
+/*  The original drive reversals. Swap this in for robot_config if turning is not
+	working in autonomous with the all positive ports above.
+	.left_drive = {-16, 18, 17},
+	.right_drive = {-13, -14, 12},
+*/
+
+#endif  // _ROBOT_SETUP_HPP_
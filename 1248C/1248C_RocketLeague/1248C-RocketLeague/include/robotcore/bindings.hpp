@@ -0,0 +1,99 @@
+/**
+ * \file bindings.hpp
+ *
+ * Robot state shown on the brain screen only when it changes.
+ *
+ * Writing a value into a widget every loop, like pros::lcd::print() of the
+ * button states in opcontrol, invalidates the widget each time even when
+ * nothing on it changed. Here robot tasks publish() values instead, and
+ * widgets are bound to them:
+ *
+ * - Each value has an LVGL subject (lv_observer). publish() only stores the
+ *   value, so any task can call it. A timer on the LVGL task copies values
+ *   that changed into their subjects once per frame, and the subjects
+ *   notify their widgets.
+ * - A binding updates its widget only if the value moved by at least
+ *   threshold from what the widget shows, and no more often than every
+ *   min_period_ms. A change held back by the rate limit is shown once the
+ *   period is up.
+ *
+ * get() gives the subject itself for LVGL's own bindings, like
+ * lv_label_bind_text(), which have no threshold or rate limit.
+ */
+
+#ifndef _ROBOTCORE_BINDINGS_HPP_
+#define _ROBOTCORE_BINDINGS_HPP_
+
+#include "liblvgl/lvgl.h"
+#include <cstdint>
+
+namespace bindings {
+
+constexpr int MAX_SUBJECTS = 16;
+constexpr int MAX_BINDINGS = 24;
+constexpr std::uint32_t SYNC_PERIOD_MS = LV_DEF_REFR_PERIOD;  // once per frame
+
+/**
+ * Shows value on obj. obj is whatever was passed to bind(), which may be
+ * nullptr. Runs on the LVGL task.
+ */
+using Apply = void (*)(lv_obj_t* obj, std::int32_t value);
+
+struct Stats {
+	std::uint32_t changes;    // values copied into their subjects
+	std::uint32_t applied;    // widget updates
+	std::uint32_t filtered;   // changes smaller than the binding's threshold
+	std::uint32_t deferred;   // changes held back by a rate limit
+};
+
+/**
+ * Starts the timer that hands published values to LVGL. Call on the LVGL
+ * task after pros::lcd::initialize(); initialize() does it from a one-shot
+ * timer.
+ */
+void start();
+
+/**
+ * A new value starting at initial, or -1 if there are already MAX_SUBJECTS.
+ * LVGL task only.
+ */
+int subject(std::int32_t initial = 0);
+
+/**
+ * Sets a value. Safe from any task; widgets see it on the next sync().
+ */
+void publish(int subject, std::int32_t value);
+
+/**
+ * Calls apply with the subject's value now and whenever it changes, within
+ * threshold and min_period_ms. The binding goes away when obj is deleted.
+ * LVGL task only.
+ */
+void bind(int subject, lv_obj_t* obj, Apply apply, std::int32_t threshold = 1, std::uint32_t min_period_ms = 0);
+
+/**
+ * Shows the value in a label with a printf format taking one int, which
+ * must outlive the label (a string literal).
+ */
+void bind_label(int subject, lv_obj_t* label, const char* format, std::int32_t threshold = 1,
+                std::uint32_t min_period_ms = 0);
+
+void bind_bar(int subject, lv_obj_t* bar, std::int32_t threshold = 1, std::uint32_t min_period_ms = 0);
+
+/**
+ * The subject behind a value, for LVGL's own bind functions. LVGL task only.
+ */
+lv_subject_t* get(int subject);
+
+/**
+ * Copies published values into their subjects and shows any rate limited
+ * change that is due. The timer from start() calls this; it is public for
+ * tools/lvgl_bench.cpp, which has no timers running between frames.
+ */
+void sync();
+
+Stats stats();
+
+}  // namespace bindings
+
+#endif  // _ROBOTCORE_BINDINGS_HPP_
@@ -0,0 +1,62 @@
+/**
+ * \file blend_neon.h
+ *
+ * NEON kernels for LVGL's ARGB8888 software blending.
+ *
+ * With LV_COLOR_DEPTH 32 every rectangle, chart background and image on the
+ * brain screen is drawn by the plain C loops in LVGL's
+ * lv_draw_sw_blend_to_argb8888.c. These replace the four that draw the
+ * dashboard: solid fill, fill with opacity, and ARGB8888 image blending with
+ * and without opacity. Masked blends stay in C.
+ *
+ * Each kernel gives exactly the pixels LVGL's C code gives, down to the
+ * rounding: eight pixels at a time where the alphas allow LVGL's simple
+ * blend, and the C formula for the rest (both colors partly transparent,
+ * which needs a divide). tools/blend_check.cpp checks that bit for bit
+ * against LVGL and times both.
+ *
+ * LVGL calls these through its custom blend hooks, which are compiled into
+ * LVGL itself. An LVGL built with
+ *
+ *   -DLV_USE_DRAW_SW_ASM=LV_DRAW_SW_ASM_CUSTOM -DLV_DRAW_SW_ASM_CUSTOM_INCLUDE='"robotcore/blend_neon.h"'
+ *
+ * uses them (tools/lvgl_bench_conf.h does this with -DROBOTCORE_NEON_BLEND).
+ * The liblvgl.a in the PROS kernel template is prebuilt without the hooks, so
+ * the brain only runs these once liblvgl is rebuilt with those two defines.
+ * Built without NEON the kernels return LV_RESULT_INVALID and LVGL uses its C
+ * loops.
+ */
+
+#ifndef _ROBOTCORE_BLEND_NEON_H_
+#define _ROBOTCORE_BLEND_NEON_H_
+
+#include "liblvgl/lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+lv_result_t blend_neon_color_to_argb8888(lv_draw_sw_blend_fill_dsc_t* dsc);
+lv_result_t blend_neon_color_to_argb8888_with_opa(lv_draw_sw_blend_fill_dsc_t* dsc);
+lv_result_t blend_neon_argb8888_to_argb8888(lv_draw_sw_blend_image_dsc_t* dsc);
+lv_result_t blend_neon_argb8888_to_argb8888_with_opa(lv_draw_sw_blend_image_dsc_t* dsc);
+
+/**
+ * The same four blends one pixel at a time, following LVGL 9.2's C code.
+ * The kernels use these for the pixels they can't do eight at a time.
+ */
+void blend_reference_color_to_argb8888(lv_draw_sw_blend_fill_dsc_t* dsc);
+void blend_reference_color_to_argb8888_with_opa(lv_draw_sw_blend_fill_dsc_t* dsc);
+void blend_reference_argb8888_to_argb8888(lv_draw_sw_blend_image_dsc_t* dsc);
+void blend_reference_argb8888_to_argb8888_with_opa(lv_draw_sw_blend_image_dsc_t* dsc);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#define LV_DRAW_SW_COLOR_BLEND_TO_ARGB8888(dsc) blend_neon_color_to_argb8888(dsc)
+#define LV_DRAW_SW_COLOR_BLEND_TO_ARGB8888_WITH_OPA(dsc) blend_neon_color_to_argb8888_with_opa(dsc)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_ARGB8888(dsc) blend_neon_argb8888_to_argb8888(dsc)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_ARGB8888_WITH_OPA(dsc) blend_neon_argb8888_to_argb8888_with_opa(dsc)
+
+#endif  // _ROBOTCORE_BLEND_NEON_H_
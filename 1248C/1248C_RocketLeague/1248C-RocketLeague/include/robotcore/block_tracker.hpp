@@ -0,0 +1,48 @@
+/**
+ * \file block_tracker.hpp
+ *
+ * Loose block tracking with the AI Vision sensor.
+ *
+ * A background task reads the sensor's detections into a fixed array (no
+ * std::vector, nothing allocated after start()), matches them against the
+ * blocks it saw last frame, and keeps a short list of tracked blocks. The
+ * closest confirmed block is published as a heading that autonomous can steer
+ * toward.
+ *
+ * Only blocks of the alliance color from color_sort::alliance() are tracked,
+ * and none at all until an alliance is picked.
+ */
+
+#ifndef _ROBOTCORE_BLOCK_TRACKER_HPP_
+#define _ROBOTCORE_BLOCK_TRACKER_HPP_
+
+#include <cstdint>
+
+namespace block_tracker {
+
+/**
+ * A block the tracker is steering toward.
+ */
+struct Target {
+	std::uint8_t track_id;  // stays the same while the same block is in view
+	double heading_deg;     // angle from straight ahead, positive is to the right
+	double size;            // bounding box area as a fraction of the image, bigger is closer
+};
+
+/**
+ * Configures the sensor's block colors and starts the tracking task. Call once
+ * from initialize().
+ */
+void start();
+
+/**
+ * Gets the block to steer toward.
+ *
+ * \param target Filled in when a block is being tracked.
+ * \return true if a confirmed block is in view.
+ */
+bool get_target(Target& target);
+
+}  // namespace block_tracker
+
+#endif  // _ROBOTCORE_BLOCK_TRACKER_HPP_
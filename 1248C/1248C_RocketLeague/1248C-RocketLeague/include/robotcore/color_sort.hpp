@@ -0,0 +1,69 @@
+/**
+ * \file color_sort.hpp
+ *
+ * Block color sorting on the conveyor.
+ *
+ * A high priority task polls the optical sensor next to the conveyor. When an
+ * opponent-colored block goes past, it works out how long the block will take
+ * to reach the top roller from the current conveyor velocity and reverses the
+ * top roller just long enough to throw that block out.
+ */
+
+#ifndef _ROBOTCORE_COLOR_SORT_HPP_
+#define _ROBOTCORE_COLOR_SORT_HPP_
+
+#include <cstdint>
+
+namespace color_sort {
+
+enum class Alliance { none, red, blue };
+
+/**
+ * Starts the sorting task. Call once from initialize().
+ *
+ * \param keep The alliance color to keep. Blocks of the other color are
+ *        ejected. Alliance::none passes every block through.
+ */
+void start(Alliance keep);
+
+/**
+ * Changes which alliance color is kept (e.g. from the autonomous selector).
+ */
+void set_alliance(Alliance keep);
+
+/**
+ * The alliance color being kept, Alliance::none until one is chosen.
+ */
+Alliance alliance();
+
+/**
+ * Turns sorting on or off without stopping the task.
+ */
+void set_enabled(bool enabled);
+
+/**
+ * Returns true while the top roller is being reversed to eject a block.
+ *
+ * Code that writes the top roller every loop (opcontrol) should leave it alone
+ * while this is true.
+ */
+bool ejecting();
+
+/**
+ * Number of blocks that have gone past the sensor since start(), kept or not.
+ */
+std::uint32_t blocks_seen();
+
+/**
+ * Number of blocks ejected since start().
+ */
+std::uint32_t ejected_count();
+
+/**
+ * Worst time in microseconds the sorter has spent deciding on one block.
+ */
+std::uint32_t worst_decision_us();
+
+}  // namespace color_sort
+
+#endif  // _ROBOTCORE_COLOR_SORT_HPP_
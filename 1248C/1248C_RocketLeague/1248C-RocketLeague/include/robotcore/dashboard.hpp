@@ -0,0 +1,61 @@
+/**
+ * \file dashboard.hpp
+ *
+ * Live telemetry dashboard on the brain screen.
+ *
+ * The control loop hands one Sample per tick to push(), which drops it into a
+ * lock-free queue and returns. An LVGL timer on the display task drains the
+ * queue every DRAW_PERIOD_MS and adds every sample to the stream charts,
+ * which keep the minimum and maximum of each pair of samples and redraw only
+ * their new columns. The timer stops early if it goes over its CPU budget,
+ * so drawing never holds up the robot tasks.
+ *
+ * The dashboard is its own screen. Press the right LLEMU button to show it
+ * and tap anywhere on it to go back to the LLEMU text.
+ */
+
+#ifndef _ROBOTCORE_DASHBOARD_HPP_
+#define _ROBOTCORE_DASHBOARD_HPP_
+
+#include <cstdint>
+
+namespace dashboard {
+
+constexpr int DRIVE_MOTORS = 6;  // left 3, then right 3
+
+struct Sample {
+	std::int16_t drive_current_ma[DRIVE_MOTORS];
+	std::int8_t drive_temp_c[DRIVE_MOTORS];
+	std::int8_t conveyor_temp_c;
+	std::int8_t top_roller_temp_c;
+	std::uint16_t blocks_seen;   // running count from the color sorter
+	std::int16_t loop_jitter_us; // how late this control loop tick started
+};
+
+/**
+ * Builds the dashboard screen and starts its LVGL timer. Call once on the
+ * LVGL task, after pros::lcd::initialize(); initialize() does it from a
+ * one-shot timer.
+ */
+void start();
+
+/**
+ * Queues a sample for drawing. Safe to call from the control loop: it never
+ * blocks, and if the dashboard has fallen behind the sample is dropped.
+ */
+void push(const Sample& sample);
+
+/**
+ * Fills in everything in a Sample except loop_jitter_us from the robot's
+ * motors and sensors.
+ */
+void read_robot(Sample& sample);
+
+/**
+ * Switches between the dashboard and the LLEMU text screen.
+ */
+void show(bool visible);
+
+}  // namespace dashboard
+
+#endif  // _ROBOTCORE_DASHBOARD_HPP_
@@ -0,0 +1,89 @@
+/**
+ * \file ghost.hpp
+ *
+ * Record a driver run and play it back as an autonomous ("ghost driver").
+ *
+ * While recording, opcontrol hands record() one Frame per tick: the motor
+ * commands it sent, the solenoid states and the drive encoder positions.
+ * record() only drops the frame in a queue. A low priority task
+ * delta-encodes the frames and writes them to the SD card in 512 byte
+ * chunks, so the control loop never waits on the card.
+ *
+ * play() reads the file back 512 bytes at a time and replays each frame at
+ * the time it was recorded. The drive gets the recorded command plus a
+ * correction toward the recorded encoder positions, so the robot follows
+ * where it went and not just what it was told. Memory use is the same for a
+ * 10 second run and a 60 second one.
+ *
+ * File format: "GHST", a version byte, then one record per frame. A record
+ * is a byte saying which fields changed, the ms since the last frame as a
+ * varint, then each changed field as a zigzag varint delta (the solenoid bits
+ * are stored as-is). A tick where nothing changed takes two bytes.
+ */
+
+#ifndef _ROBOTCORE_GHOST_HPP_
+#define _ROBOTCORE_GHOST_HPP_
+
+#include <cstdint>
+
+namespace ghost {
+
+constexpr const char* DEFAULT_FILE = "/usd/ghost.bin";
+
+// Solenoid bits in Frame::solenoids
+constexpr std::uint8_t DESCORER_BIT = 1 << 0;
+constexpr std::uint8_t MATCH_LOADER_BIT = 1 << 1;
+
+struct Frame {
+	std::uint32_t time_ms;  // pros::millis() when the tick ran
+	std::int32_t left;      // motor commands, -127 to 127
+	std::int32_t right;
+	std::int32_t conveyor;
+	std::int32_t top_roller;
+	double left_deg;        // drive get_position(), zeroed when recording starts
+	double right_deg;
+	std::uint8_t solenoids;
+};
+
+/**
+ * Starts the SD card writer task. Call once from initialize().
+ */
+void start();
+
+/**
+ * Opens a new recording and zeroes the drive encoders.
+ *
+ * \return false if there is no SD card, the file can't be created, or the
+ * last recording is still being written out.
+ */
+bool begin_recording(const char* path = DEFAULT_FILE);
+
+/**
+ * Queues one tick of the run. Never blocks; does nothing when not recording.
+ * Stamp frames with pros::millis(), the recording makes the times relative.
+ */
+void record(const Frame& frame);
+
+/**
+ * Stops recording. The writer task flushes and closes the file.
+ */
+void end_recording();
+
+bool recording();
+
+/**
+ * Frames dropped because the writer fell behind. Nonzero means the
+ * recording has gaps.
+ */
+std::uint32_t dropped();
+
+/**
+ * Plays a recording back on the robot. Blocks until the run is over.
+ *
+ * \return false if the file is missing or not a recording.
+ */
+bool play(const char* path = DEFAULT_FILE);
+
+}  // namespace ghost
+
+#endif  // _ROBOTCORE_GHOST_HPP_
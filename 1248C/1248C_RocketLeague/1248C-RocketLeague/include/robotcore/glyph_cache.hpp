@@ -0,0 +1,46 @@
+/**
+ * \file glyph_cache.hpp
+ *
+ * Decoded glyph cache for the brain screen's text.
+ *
+ * lv_conf.h turns on LV_USE_FONT_COMPRESSED, so every time a label is
+ * redrawn each of its letters is decompressed again, and LLEMU lines are
+ * reprinted every loop. attach() points the labels under a screen at a copy
+ * of their font that keeps decoded glyphs in an atlas: one static buffer cut
+ * into SLOTS equal slots, with an LVGL LRU cache (lv_cache_class_lru_rb_count)
+ * deciding which glyphs keep a slot. A letter already in the atlas is copied
+ * out instead of decoded. Glyphs bigger than a slot skip the cache.
+ *
+ * The atlas is static, so it costs no heap; the cache's bookkeeping comes
+ * from LVGL's own pool.
+ */
+
+#ifndef _ROBOTCORE_GLYPH_CACHE_HPP_
+#define _ROBOTCORE_GLYPH_CACHE_HPP_
+
+#include "liblvgl/lvgl.h"
+#include <cstdint>
+
+namespace glyph_cache {
+
+constexpr int SLOTS = 2 * 95;           // the 95 printable ASCII characters in two sizes
+constexpr int SLOT_BYTES = 32 * 32;     // one A8 glyph up to 32x32
+constexpr int MAX_FONTS = 4;
+
+struct Stats {
+	std::uint32_t hits;
+	std::uint32_t misses;    // decoded into the atlas
+	std::uint32_t uncached;  // too big for a slot, or the font didn't decode into our buffer
+};
+
+/**
+ * Makes every label under root draw through the cache, whatever font it
+ * uses now. Run it again after adding labels. LVGL task only.
+ */
+void attach(lv_obj_t* root);
+
+Stats stats();
+
+}  // namespace glyph_cache
+
+#endif  // _ROBOTCORE_GLYPH_CACHE_HPP_
@@ -0,0 +1,54 @@
+/**
+ * \file heap_guard.hpp
+ *
+ * Keeps the heap still once the robot is running.
+ *
+ * Everything in robotcore keeps its memory in fixed static storage sized at
+ * compile time, so nothing needs the heap after initialize(). A heap that
+ * keeps growing and shrinking over a long event day fragments, so this is
+ * how we keep it that way:
+ *
+ * - seal() at the end of initialize() marks the point after which nothing
+ *   should allocate. In every build, guard or not, it also gets newlib's
+ *   FILE pool allocated while that is still allowed, so later fopen() calls
+ *   reuse it instead of allocating mid-match.
+ * - Building with `make HEAP_GUARD=1` replaces the global operator new. Up
+ *   to seal() it counts what was allocated. After seal() any allocation
+ *   prints the caller's address on the serial console and stops the program
+ *   with a trap, so the brain shows where it happened. Normal builds don't
+ *   include any of this.
+ *
+ * Only allocations that go through operator new (new, std::vector,
+ * std::function, ...) are caught, wherever they are made: our code, the
+ * PROS C++ API or libstdc++. HEAP_GUARD=1 builds a monolith for that,
+ * because a hot/cold build links the cold package, with libpros and
+ * libstdc++ in it, against the stock operator new. Direct malloc() calls,
+ * from the PROS kernel, newlib or anyone else, are not covered.
+ * motor_io.hpp has allocation-free versions of the MotorGroup *_all()
+ * calls, which each return a new std::vector.
+ */
+
+#ifndef _ROBOTCORE_HEAP_GUARD_HPP_
+#define _ROBOTCORE_HEAP_GUARD_HPP_
+
+#include <cstdint>
+
+namespace heap_guard {
+
+/**
+ * Marks the end of start-up allocation. Call last thing in initialize().
+ */
+void seal();
+
+bool sealed();
+
+/**
+ * C++ allocations made before seal(). Always 0 unless built with
+ * HEAP_GUARD=1.
+ */
+std::uint32_t startup_allocations();
+std::uint32_t startup_bytes();
+
+}  // namespace heap_guard
+
+#endif  // _ROBOTCORE_HEAP_GUARD_HPP_
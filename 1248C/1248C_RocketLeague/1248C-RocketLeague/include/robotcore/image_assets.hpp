@@ -0,0 +1,71 @@
+/**
+ * \file image_assets.hpp
+ *
+ * Compressed images from the SD card, decoded once and cached while shown.
+ *
+ * Logos and field maps are too big to keep in the program as ARGB arrays.
+ * tools/image_compiler.cpp turns a PNG into LVGL's binary image format (the
+ * file form of an lv_image_dsc_t) compressed with LVGL's RLE or with LZ4.
+ * Copy the .bin to the SD card and show it with create(parent, "S:logo.bin");
+ * lv_conf.h maps the S: drive to /usd/.
+ *
+ * The PROS liblvgl is built without LV_USE_RLE and LV_USE_LZ4, so its own
+ * decoder can't read compressed files. start() adds a decoder for these
+ * .bin files that reads the whole file in one go and decompresses it into
+ * a draw buffer. That buffer goes into LVGL's image cache, which lv_conf.h
+ * leaves off and start() sizes to cache_bytes, so later frames draw from it
+ * without touching the card. When a screen is unloaded, the images on it
+ * are dropped from the cache; the next time it is shown they are read again.
+ */
+
+#ifndef _ROBOTCORE_IMAGE_ASSETS_HPP_
+#define _ROBOTCORE_IMAGE_ASSETS_HPP_
+
+#include "liblvgl/lvgl.h"
+#include <cstdint>
+
+namespace image_assets {
+
+constexpr std::uint32_t CACHE_BYTES = 512 * 1024;  // a full-screen RGB565 field map and a few logos
+
+/**
+ * After the lv_image_header_t of a compressed .bin, as in LVGL's
+ * lv_bin_decoder.c, followed by compressed_size bytes.
+ */
+struct CompressedHeader {
+	std::uint32_t method;  // lv_image_compress_t
+	std::uint32_t compressed_size;
+	std::uint32_t decompressed_size;
+};
+
+struct Stats {
+	std::uint32_t decoded;        // images read from the card
+	std::uint32_t failed;         // unreadable or corrupt files
+	std::uint32_t last_decode_ms;
+};
+
+/**
+ * Adds the decoder and sizes LVGL's image cache. Call on the LVGL task
+ * after pros::lcd::initialize().
+ */
+void start(std::uint32_t cache_bytes = CACHE_BYTES);
+
+/**
+ * An lv_image showing path (an LVGL path like "S:field.bin") that is
+ * dropped from the cache whenever its screen is unloaded.
+ */
+lv_obj_t* create(lv_obj_t* parent, const char* path);
+
+/**
+ * Decompresses in into out, which must be exactly the decompressed size.
+ * pixel_size is the bytes per pixel, RLE's unit. False if the data is
+ * corrupt.
+ */
+bool decompress(lv_image_compress_t method, const std::uint8_t* in, std::uint32_t in_size, std::uint8_t* out,
+                std::uint32_t out_size, std::uint32_t pixel_size);
+
+Stats stats();
+
+}  // namespace image_assets
+
+#endif  // _ROBOTCORE_IMAGE_ASSETS_HPP_
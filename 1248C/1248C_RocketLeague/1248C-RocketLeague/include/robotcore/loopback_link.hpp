@@ -0,0 +1,97 @@
+/**
+ * \file loopback_link.hpp
+ *
+ * Stand-in for pros::Link when running partner_link code on a computer.
+ *
+ * Two LoopbackLinks connected with connect() behave like a pair of radios:
+ * bytes written to one with transmit_raw() come out of the other with
+ * receive_raw(). Each direction has a fixed size buffer, so a sender that gets
+ * ahead sees raw_transmittable_size() drop to zero just like on the robot.
+ *
+ * \code
+ * LoopbackLink a, b;
+ * LoopbackLink::connect(a, b);
+ * partner::Channel<LoopbackLink> robot_a(a), robot_b(b);
+ * robot_a.send(partner::MsgType::pose, pose);
+ * robot_b.poll(inbox);
+ * \endcode
+ */
+
+#ifndef _ROBOTCORE_LOOPBACK_LINK_HPP_
+#define _ROBOTCORE_LOOPBACK_LINK_HPP_
+
+#include <cstdint>
+#include <mutex>
+
+class LoopbackLink {
+	public:
+	static constexpr std::uint32_t BUFFER_SIZE = 512;  // about what the radio buffers
+
+	static void connect(LoopbackLink& a, LoopbackLink& b) {
+		a.out = &a.tx;
+		a.in = &b.tx;
+		b.out = &b.tx;
+		b.in = &a.tx;
+	}
+
+	bool connected() { return in != nullptr; }
+
+	std::uint32_t raw_receivable_size() {
+		if (in == nullptr) return 0;
+		std::lock_guard<std::mutex> lock(in->mutex);
+		return in->count;
+	}
+
+	std::uint32_t raw_transmittable_size() {
+		if (out == nullptr) return 0;
+		std::lock_guard<std::mutex> lock(out->mutex);
+		return BUFFER_SIZE - out->count;
+	}
+
+	std::uint32_t transmit_raw(void* data, std::uint16_t data_size) {
+		if (out == nullptr) return 0;
+		std::lock_guard<std::mutex> lock(out->mutex);
+		const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+		std::uint32_t n = 0;
+		for (; n < data_size && out->count < BUFFER_SIZE; n++) {
+			out->bytes[(out->head + out->count) % BUFFER_SIZE] = bytes[n];
+			out->count++;
+		}
+		return n;
+	}
+
+	std::uint32_t receive_raw(void* dest, std::uint16_t data_size) {
+		if (in == nullptr) return 0;
+		std::lock_guard<std::mutex> lock(in->mutex);
+		std::uint8_t* bytes = static_cast<std::uint8_t*>(dest);
+		std::uint32_t n = 0;
+		for (; n < data_size && in->count > 0; n++) {
+			bytes[n] = in->bytes[in->head];
+			in->head = (in->head + 1) % BUFFER_SIZE;
+			in->count--;
+		}
+		return n;
+	}
+
+	std::uint32_t clear_receive_buf() {
+		if (in == nullptr) return 0;
+		std::lock_guard<std::mutex> lock(in->mutex);
+		in->head = 0;
+		in->count = 0;
+		return 1;
+	}
+
+	private:
+	struct Pipe {
+		std::mutex mutex;
+		std::uint8_t bytes[BUFFER_SIZE];
+		std::uint32_t head = 0;
+		std::uint32_t count = 0;
+	};
+
+	Pipe tx;  // bytes this end has sent, waiting for the other end to read
+	Pipe* out = nullptr;
+	Pipe* in = nullptr;
+};
+
+#endif  // _ROBOTCORE_LOOPBACK_LINK_HPP_
@@ -0,0 +1,72 @@
+/**
+ * \file lvgl_heap.hpp
+ *
+ * How much of its heap LVGL uses, and a smaller one.
+ *
+ * LVGL allocates every widget, style, timer and label text from its own TLSF
+ * pool, and lv_conf.h makes that pool LV_MEM_SIZE = 10 MB, all of it taken
+ * from the robot program. stats() reads the pool through lv_mem_monitor():
+ * its peak use, its largest free block and how fragmented it is.
+ *
+ * Building with `make LVGL_SMALL_POOL=1` also links our versions in front of
+ * lv_malloc(), lv_malloc_zeroed(), lv_realloc() and lv_free() (--wrap):
+ *
+ * - Every allocation is counted by size, in powers of two.
+ * - Requests of SMALL_BLOCK_BYTES or less come from a separate pool of
+ *   SMALL_BLOCKS fixed-size blocks. Most of LVGL's allocations are small
+ *   and short-lived (event lists, label text, draw tasks); in blocks of one
+ *   size they can't break up the TLSF pool. When the small pool is full
+ *   they go to TLSF as before.
+ *
+ * `make LVGL_HEAP_KB=n` sets LV_MEM_SIZE to n KB instead of 10 MB, and the
+ * build stops if that is less than UI_HEAP_BUDGET. tools/lvgl_bench.cpp
+ * --heap is the regression check for the budget: it plays every screen the
+ * robot shows in a match and fails if LVGL ever needed more than
+ * UI_HEAP_BUDGET, or if any allocation failed. LV_MEM_SIZE sizes a static
+ * array inside liblvgl, so the PROS liblvgl.a (built with the 10 MB
+ * lv_conf.h) has to be rebuilt with the same LVGL_HEAP_KB for the robot to
+ * get the memory back.
+ */
+
+#ifndef _ROBOTCORE_LVGL_HEAP_HPP_
+#define _ROBOTCORE_LVGL_HEAP_HPP_
+
+#include "liblvgl/lvgl.h"
+#include <cstdint>
+
+namespace lvgl_heap {
+
+constexpr std::uint32_t UI_HEAP_BUDGET = 1536 * 1024;  // screens, plus image_assets::CACHE_BYTES of images
+constexpr std::uint32_t SMALL_BLOCK_BYTES = 64;
+constexpr std::uint32_t SMALL_BLOCKS = 2048;            // 128 KB
+constexpr int SIZE_BUCKETS = 14;                        // up to 16 B, 32 B, ... 64 KB, bigger
+
+struct Stats {
+	std::uint32_t pool_bytes;     // LV_MEM_SIZE, less TLSF's own overhead
+	std::uint32_t used_bytes;
+	std::uint32_t peak_bytes;     // most ever in use at once
+	std::uint32_t biggest_free;   // largest block TLSF could hand out now
+	std::uint8_t frag_percent;    // 100 - biggest_free * 100 / free bytes
+	// Only with LVGL_SMALL_POOL=1:
+	std::uint32_t small_used;     // blocks
+	std::uint32_t small_peak;     // blocks
+	std::uint32_t failed;         // allocations that returned nullptr
+	std::uint32_t sizes[SIZE_BUCKETS];
+};
+
+Stats stats();
+
+/**
+ * Prints stats() on the serial console.
+ */
+void print();
+
+/**
+ * Sends small requests to the small pool (the default) or to TLSF. Blocks
+ * already handed out stay valid. Does nothing without LVGL_SMALL_POOL=1.
+ */
+void set_small_pool(bool enabled);
+
+}  // namespace lvgl_heap
+
+#endif  // _ROBOTCORE_LVGL_HEAP_HPP_
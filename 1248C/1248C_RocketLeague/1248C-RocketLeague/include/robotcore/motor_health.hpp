@@ -0,0 +1,52 @@
+/**
+ * \file motor_health.hpp
+ *
+ * Drive motor thermal watchdog.
+ *
+ * A low-rate task keeps a simple thermal model for each drive motor. The
+ * model heats up with current squared, cools toward room temperature, and is
+ * pulled toward the motor's own temperature reading. From it the task
+ * predicts how long each motor has until the firmware starts limiting it at
+ * 55 C. A motor that is getting close gets less of its side's drive output
+ * and the other motors on that side make up the difference, so the side
+ * keeps its torque for longer. The driver is warned with a controller rumble
+ * and a line on the brain screen.
+ *
+ * Drive through move_drive() instead of left_mg.move()/right_mg.move() so the
+ * rebalancing is applied.
+ */
+
+#ifndef _ROBOTCORE_MOTOR_HEALTH_HPP_
+#define _ROBOTCORE_MOTOR_HEALTH_HPP_
+
+#include <cstdint>
+
+namespace motor_health {
+
+constexpr int DRIVE_MOTORS = 6;  // left 3, then right 3
+
+/**
+ * Starts the watchdog task. Call once from initialize().
+ */
+void start();
+
+/**
+ * Sets the drive sides like left_mg.move()/right_mg.move(), with each motor's
+ * share adjusted for its temperature.
+ */
+void move_drive(std::int32_t left, std::int32_t right);
+
+/**
+ * Predicted seconds until a drive motor reaches the throttle temperature, or
+ * a negative number if at the current load it never will.
+ */
+float seconds_to_throttle(int motor);
+
+/**
+ * Modeled temperature of a drive motor in degrees C.
+ */
+float modeled_temp_c(int motor);
+
+}  // namespace motor_health
+
+#endif  // _ROBOTCORE_MOTOR_HEALTH_HPP_
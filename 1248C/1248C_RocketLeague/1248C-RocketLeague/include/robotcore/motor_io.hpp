@@ -0,0 +1,81 @@
+/**
+ * \file motor_io.hpp
+ *
+ * Allocation-free replacements for the MotorGroup *_all() calls.
+ *
+ * get_position_all(), get_current_draw_all() and the rest each build and
+ * return a new std::vector, so calling them every loop churns the heap. These
+ * fill a fixed array the caller owns instead, one motor at a time through
+ * the indexed getters, and return how many motors were read.
+ *
+ * \code
+ * std::int32_t currents[DRIVE_MOTORS_PER_SIDE];
+ * motor_io::current_draw(left_mg, currents);
+ * \endcode
+ */
+
+#ifndef _ROBOTCORE_MOTOR_IO_HPP_
+#define _ROBOTCORE_MOTOR_IO_HPP_
+
+#include "main.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace motor_io {
+
+/**
+ * Reads one value per motor with an indexed MotorGroup getter.
+ *
+ * \return the number of motors read, the smaller of the group size and N.
+ */
+template <typename T, std::size_t N, typename R>
+int read_each(const pros::MotorGroup& group, R (pros::MotorGroup::*getter)(std::uint8_t) const, T (&out)[N]) {
+	int count = group.size();
+	if (count > static_cast<int>(N)) count = N;
+	for (int i = 0; i < count; i++) out[i] = static_cast<T>((group.*getter)(static_cast<std::uint8_t>(i)));
+	return count;
+}
+
+template <std::size_t N>
+int position(const pros::MotorGroup& group, double (&out)[N]) {
+	return read_each(group, &pros::MotorGroup::get_position, out);
+}
+
+template <std::size_t N>
+int actual_velocity(const pros::MotorGroup& group, double (&out)[N]) {
+	return read_each(group, &pros::MotorGroup::get_actual_velocity, out);
+}
+
+template <typename T, std::size_t N>
+int current_draw(const pros::MotorGroup& group, T (&out)[N]) {
+	return read_each(group, &pros::MotorGroup::get_current_draw, out);
+}
+
+template <typename T, std::size_t N>
+int voltage(const pros::MotorGroup& group, T (&out)[N]) {
+	return read_each(group, &pros::MotorGroup::get_voltage, out);
+}
+
+template <typename T, std::size_t N>
+int temperature(const pros::MotorGroup& group, T (&out)[N]) {
+	return read_each(group, &pros::MotorGroup::get_temperature, out);
+}
+
+template <std::size_t N>
+int efficiency(const pros::MotorGroup& group, double (&out)[N]) {
+	return read_each(group, &pros::MotorGroup::get_efficiency, out);
+}
+
+template <std::size_t N>
+int power(const pros::MotorGroup& group, double (&out)[N]) {
+	return read_each(group, &pros::MotorGroup::get_power, out);
+}
+
+template <std::size_t N>
+int torque(const pros::MotorGroup& group, double (&out)[N]) {
+	return read_each(group, &pros::MotorGroup::get_torque, out);
+}
+
+}  // namespace motor_io
+
+#endif  // _ROBOTCORE_MOTOR_IO_HPP_
@@ -0,0 +1,227 @@
+/**
+ * \file partner_link.hpp
+ *
+ * Robot-to-robot coordination over VEXlink.
+ *
+ * Messages go over the radio as small binary frames:
+ *
+ *   [0xA5] [type] [seq] [len] [payload: len bytes] [crc16 lo] [crc16 hi]
+ *
+ * The CRC (CRC-16/CCITT-FALSE) covers type, seq, len and the payload. Frames
+ * that fail the CRC or have an unknown type are dropped and the decoder
+ * resyncs on the next 0xA5.
+ *
+ * The framing lives in the Channel template so it runs unchanged against
+ * pros::Link on the robot and LoopbackLink (loopback_link.hpp) on a computer.
+ * Anything with pros::Link's raw_receivable_size(), raw_transmittable_size(),
+ * transmit_raw() and receive_raw() works as the transport.
+ * tools/partner_link_check.cpp runs two robots over LoopbackLink on a computer.
+ */
+
+#ifndef _ROBOTCORE_PARTNER_LINK_HPP_
+#define _ROBOTCORE_PARTNER_LINK_HPP_
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+namespace partner {
+
+enum class MsgType : std::uint8_t { pose = 1, intent = 2, claim = 3 };
+
+// Where the robot is on the field
+struct __attribute__((packed)) Pose {
+	std::int16_t x_mm;
+	std::int16_t y_mm;
+	std::uint16_t heading_cdeg;  // hundredths of a degree, 0-35999
+};
+
+enum class Action : std::uint8_t { idle = 0, load = 1, score = 2, defend = 3, park = 4 };
+
+// What the robot is about to do and roughly when it gets there
+struct __attribute__((packed)) Intent {
+	Action action;
+	std::uint8_t goal_id;
+	std::uint16_t eta_ms;
+};
+
+// "I'm taking this goal, stay off it" (or releasing it)
+struct __attribute__((packed)) Claim {
+	std::uint8_t goal_id;
+	std::uint8_t claimed;
+	std::uint16_t hold_ms;
+};
+
+constexpr std::uint8_t FRAME_SYNC = 0xA5;
+constexpr std::uint16_t FRAME_HEADER = 4;  // sync, type, seq, len
+constexpr std::uint16_t FRAME_CRC = 2;
+constexpr std::uint16_t MAX_PAYLOAD = 8;
+constexpr std::uint16_t MAX_FRAME = FRAME_HEADER + MAX_PAYLOAD + FRAME_CRC;
+constexpr std::uint32_t LINK_ERR = INT32_MAX;  // PROS_ERR, what pros::Link returns on failure
+
+static_assert(sizeof(Pose) <= MAX_PAYLOAD && sizeof(Intent) <= MAX_PAYLOAD && sizeof(Claim) <= MAX_PAYLOAD,
+              "message does not fit in a frame");
+
+inline std::uint16_t crc16(const std::uint8_t* data, std::uint16_t size, std::uint16_t crc = 0xFFFF) {
+	for (std::uint16_t i = 0; i < size; i++) {
+		crc ^= static_cast<std::uint16_t>(data[i]) << 8;
+		for (int bit = 0; bit < 8; bit++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+	}
+	return crc;
+}
+
+constexpr std::uint16_t payload_size(MsgType type) {
+	switch (type) {
+		case MsgType::pose: return sizeof(Pose);
+		case MsgType::intent: return sizeof(Intent);
+		case MsgType::claim: return sizeof(Claim);
+	}
+	return 0;
+}
+
+/**
+ * The latest message of each type received from the partner.
+ *
+ * Messages are decoded straight from the receive buffer into these fixed
+ * structs, there is no intermediate parse step.
+ */
+struct Inbox {
+	Pose pose;
+	Intent intent;
+	Claim claim;
+	std::uint32_t pose_count;
+	std::uint32_t intent_count;
+	std::uint32_t claim_count;
+	std::uint32_t bad_frames;
+};
+
+/**
+ * Frames messages onto a transport and decodes whatever the partner sent.
+ *
+ * Neither send() nor poll() ever blocks: send() gives up if the radio's
+ * transmit buffer is full, and poll() only reads bytes that are already there.
+ */
+template <typename Transport>
+class Channel {
+	public:
+	explicit Channel(Transport& transport) : transport(transport) {}
+
+	/**
+	 * Frames and sends one message.
+	 *
+	 * \return false if the transmit buffer had no room; try again next tick.
+	 */
+	template <typename Msg>
+	bool send(MsgType type, const Msg& msg) {
+		static_assert(sizeof(Msg) <= MAX_PAYLOAD, "message does not fit in a frame");
+		std::uint8_t frame[MAX_FRAME];
+		std::uint16_t len = sizeof(Msg);
+		frame[0] = FRAME_SYNC;
+		frame[1] = static_cast<std::uint8_t>(type);
+		frame[2] = tx_seq++;
+		frame[3] = static_cast<std::uint8_t>(len);
+		std::memcpy(frame + FRAME_HEADER, &msg, len);
+		std::uint16_t crc = crc16(frame + 1, FRAME_HEADER - 1 + len);
+		frame[FRAME_HEADER + len] = crc & 0xFF;
+		frame[FRAME_HEADER + len + 1] = crc >> 8;
+
+		std::uint16_t size = FRAME_HEADER + len + FRAME_CRC;
+		std::uint32_t room = transport.raw_transmittable_size();
+		if (room == LINK_ERR || room < size) return false;
+		return transport.transmit_raw(frame, size) == size;
+	}
+
+	/**
+	 * Reads whatever bytes have arrived and decodes complete frames into inbox.
+	 *
+	 * \return the number of good frames decoded.
+	 */
+	int poll(Inbox& inbox) {
+		std::uint32_t available = transport.raw_receivable_size();
+		if (available == LINK_ERR) return 0;
+		std::uint32_t room = sizeof(rx) - rx_len;
+		if (available > room) available = room;
+		if (available > 0) {
+			// pros::Link returns PROS_ERR here on failure; adding that to
+			// rx_len would send the decoder off the end of rx.
+			std::uint32_t received = transport.receive_raw(rx + rx_len, available);
+			if (received == LINK_ERR || received > available) return 0;
+			rx_len += received;
+		}
+
+		int decoded = 0;
+		std::uint16_t pos = 0;
+		while (rx_len - pos >= FRAME_HEADER + FRAME_CRC) {
+			if (rx[pos] != FRAME_SYNC) {
+				pos++;
+				continue;
+			}
+			MsgType type = static_cast<MsgType>(rx[pos + 1]);
+			std::uint16_t len = rx[pos + 3];
+			if (len == 0 || len != payload_size(type)) {
+				inbox.bad_frames++;
+				pos++;
+				continue;
+			}
+			if (rx_len - pos < FRAME_HEADER + len + FRAME_CRC) break;  // rest of frame not here yet
+
+			const std::uint8_t* payload = rx + pos + FRAME_HEADER;
+			std::uint16_t crc = payload[len] | (payload[len + 1] << 8);
+			if (crc != crc16(rx + pos + 1, FRAME_HEADER - 1 + len)) {
+				inbox.bad_frames++;
+				pos++;
+				continue;
+			}
+			switch (type) {
+				case MsgType::pose: std::memcpy(&inbox.pose, payload, len); inbox.pose_count++; break;
+				case MsgType::intent: std::memcpy(&inbox.intent, payload, len); inbox.intent_count++; break;
+				case MsgType::claim: std::memcpy(&inbox.claim, payload, len); inbox.claim_count++; break;
+			}
+			decoded++;
+			pos += FRAME_HEADER + len + FRAME_CRC;
+		}
+
+		// Keep any partial frame at the front of the buffer for next time.
+		if (pos > 0) {
+			std::memmove(rx, rx + pos, rx_len - pos);
+			rx_len -= pos;
+		}
+		return decoded;
+	}
+
+	private:
+	Transport& transport;
+	std::uint8_t rx[4 * MAX_FRAME];
+	std::uint16_t rx_len = 0;
+	std::uint8_t tx_seq = 0;
+};
+
+/**
+ * Starts the link task on the robot's radio. Call once from initialize().
+ *
+ * \param transmitter One robot of the pair must be the transmitter and the
+ *        other the receiver. The transmitter gets twice the bandwidth. Pass
+ *        robot_config.link_transmitter so the role is set with the robot's
+ *        ports, not in main.cpp.
+ */
+void start(bool transmitter);
+
+/**
+ * Queues this robot's pose, intent or goal claim to go out on the next link
+ * tick. A newer message of the same type replaces one that has not been sent.
+ * Never blocks. Send each message type from one task only.
+ */
+void send_pose(const Pose& pose);
+void send_intent(const Intent& intent);
+void send_claim(const Claim& claim);
+
+/**
+ * Copies out the latest messages from the partner. Never blocks.
+ *
+ * \return false if nothing has been heard from the partner in the last second.
+ */
+bool get_inbox(Inbox& inbox);
+
+}  // namespace partner
+
+#endif  // _ROBOTCORE_PARTNER_LINK_HPP_
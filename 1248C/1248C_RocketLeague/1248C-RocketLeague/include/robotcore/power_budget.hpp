@@ -0,0 +1,57 @@
+/**
+ * \file power_budget.hpp
+ *
+ * Battery-aware power arbiter for the drive, conveyor and top roller.
+ *
+ * Each tick the control loop hands allocate() the command every subsystem
+ * wants. The arbiter estimates the current those commands would draw from
+ * each motor's speed (a motor already turning at the commanded speed draws
+ * little, a stalled one a lot), works out how much current the battery can
+ * give right now from its voltage, corrects the estimate against the
+ * battery's measured draw, and hands the budget out in priority order.
+ * Whoever is first gets all it asked for; whoever comes after gets what is
+ * left, scaled down evenly. With three consumers that is a fixed amount of
+ * work per tick.
+ *
+ * The drive goes first while it is pushing (high command, little speed);
+ * otherwise the intake goes first so scoring doesn't stall.
+ */
+
+#ifndef _ROBOTCORE_POWER_BUDGET_HPP_
+#define _ROBOTCORE_POWER_BUDGET_HPP_
+
+#include <cstdint>
+
+namespace power {
+
+/**
+ * Motor commands, -127 to 127, for every consumer on the budget.
+ */
+struct Commands {
+	std::int32_t left;
+	std::int32_t right;
+	std::int32_t conveyor;
+	std::int32_t top_roller;
+};
+
+/**
+ * Fits the wanted commands into the battery's current budget for this tick.
+ *
+ * \return the commands to actually send.
+ */
+Commands allocate(const Commands& wanted);
+
+/**
+ * Current budget in amps from the last allocate(), after the correction
+ * against the battery's measured draw.
+ */
+float budget_amps();
+
+/**
+ * True if the last allocate() decided the drive was pushing.
+ */
+bool pushing();
+
+}  // namespace power
+
+#endif  // _ROBOTCORE_POWER_BUDGET_HPP_
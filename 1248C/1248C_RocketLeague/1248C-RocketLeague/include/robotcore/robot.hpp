@@ -0,0 +1,91 @@
+/**
+ * \file robot.hpp
+ *
+ * Shared robot hardware.
+ *
+ * Every motor, solenoid and sensor on the robot is declared here so that
+ * main.cpp and the background subsystems (color sorting, etc.) all drive the
+ * same device objects. The variables are inline so this header can be
+ * included from any number of source files. Ports and gearing come from the
+ * program's own include/robot_setup.hpp.
+ *
+ * That makes every source file including this one specific to one robot, so
+ * those files in src/robotcore are built into RocketLeague only and not into
+ * robotcore.a (ROBOT_SOURCES in its Makefile). Another program linking the
+ * archive gets its devices from this header and its own robot_setup.hpp, and
+ * fails to link if it calls color_sort, settle or any other subsystem built on
+ * them, rather than running them on RocketLeague's ports.
+ */
+
+#ifndef _ROBOTCORE_ROBOT_HPP_
+#define _ROBOTCORE_ROBOT_HPP_
+
+#include "main.h"
+#include "robotcore/robot_config.hpp"
+#include "robotcore/tune.hpp"
+#include "robot_setup.hpp"  // this program's robot_config
+#include <atomic>
+
+static_assert(robot_config_check::smart_ports_ok(robot_config), "robot_config: smart port out of range or used twice");
+static_assert(robot_config_check::adi_ports_ok(robot_config), "robot_config: ADI port out of range or used twice");
+static_assert(robot_config_check::gearing_ok(robot_config), "robot_config: bad cartridge or drivetrain measurement");
+
+// Conveyor and top roller motors
+inline pros::Motor conveyor(robot_config.conveyor, robot_config.conveyor_gear);
+inline pros::Motor top_roller(robot_config.top_roller, robot_config.top_roller_gear);
+
+// Drivetrain, built from the ports and measurements in robot_config
+using Drive = Drivetrain<robot_config>;
+inline Drive drive;
+inline pros::MotorGroup& left_mg = drive.left;
+inline pros::MotorGroup& right_mg = drive.right;
+
+// Full speed of the drive motors in the rpm get_actual_velocity() reports. It
+// is read back from the motors because their cartridge setting is only forced
+// from robot_config once the drive has been measured.
+inline double drive_max_rpm() { return cartridge_rpm(left_mg.get_gearing()); }
+
+// Match loader solenoids
+inline pros::adi::DigitalOut descorer(robot_config.descorer);
+inline pros::adi::DigitalOut match_loader_solenoid(robot_config.match_loader);
+
+// Optical sensor looking at blocks on the conveyor, just below the top roller
+inline pros::Optical block_sensor(robot_config.block_sensor);
+
+// AI Vision sensor on the front of the robot for finding loose blocks
+inline pros::AIVision block_camera(robot_config.block_camera);
+
+// Conveyor and top roller speeds used by the macros below
+constexpr int CONVEYOR_SPEED = 120;
+constexpr int TOP_ROLLER_SPEED = -120;
+constexpr int TOP_ROLLER_REVERSE_SPEED = 90;
+
+// Conveyor control macros
+#define conveyor_on() conveyor.move(CONVEYOR_SPEED)
+#define conveyor_off() conveyor.move(0)
+#define conveyor_reverse() conveyor.move(-CONVEYOR_SPEED)
+
+// Every top roller command goes through move_top_roller(). The color sorter
+// compares the count before and after an eject so it only puts the roller
+// back if nothing else commanded it in the meantime.
+inline std::atomic<std::uint32_t> top_roller_commands{0};
+inline std::atomic<std::int32_t> top_roller_power{0};  // last commanded, -127 to 127
+
+inline void move_top_roller(std::int32_t power) {
+	top_roller_power = power;
+	top_roller_commands++;
+	top_roller.move(power);
+}
+
+// Top roller control macros
+#define top_roller_on() move_top_roller(TOP_ROLLER_SPEED)
+#define top_roller_off() move_top_roller(0)
+#define top_roller_reverse() move_top_roller(TOP_ROLLER_REVERSE_SPEED)
+
+// Turn both on
+#define intake_on() do { conveyor_on(); top_roller_on(); } while(0)
+
+// Store match loads (conveyor on, top roller in reverse at half speed)
+#define store_match_load() do { conveyor.move(CONVEYOR_SPEED); move_top_roller(tune::current().store_roller_speed); } while(0)
+
+#endif  // _ROBOTCORE_ROBOT_HPP_
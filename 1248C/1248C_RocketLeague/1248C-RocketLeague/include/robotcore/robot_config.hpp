@@ -0,0 +1,136 @@
+/**
+ * \file robot_config.hpp
+ *
+ * Compile-time description of the robot.
+ *
+ * Every port, reversal, cartridge and drivetrain measurement lives in one
+ * constexpr RobotConfig. Each program that uses robotcore describes its own
+ * robot in include/robot_setup.hpp, which defines robot_config; the
+ * static_asserts in robot.hpp reject a config with a port used twice or a
+ * drivetrain that doesn't add up, so a bad port change fails the build
+ * instead of the match. robot.hpp builds the actual devices from this, and
+ * Drivetrain<Config> turns the measurements into constants the compiler
+ * folds into the code, so nothing is looked up at runtime.
+ */
+
+#ifndef _ROBOTCORE_ROBOT_CONFIG_HPP_
+#define _ROBOTCORE_ROBOT_CONFIG_HPP_
+
+#include "main.h"
+#include <cstdint>
+#include <initializer_list>
+
+constexpr int DRIVE_MOTORS_PER_SIDE = 3;
+
+struct RobotConfig {
+	// Smart ports, negative means the motor is reversed
+	std::int8_t left_drive[DRIVE_MOTORS_PER_SIDE];
+	std::int8_t right_drive[DRIVE_MOTORS_PER_SIDE];
+	std::int8_t conveyor;
+	std::int8_t top_roller;
+	std::uint8_t block_sensor;  // optical, 0 if the robot has none
+	std::uint8_t block_camera;  // AI vision, 0 if the robot has none
+	std::uint8_t radio;         // VEXlink, 0 if the robot has none
+	bool link_transmitter;      // VEXlink role, the partner robot has to be built with the other one
+
+	// ADI (three-wire) ports
+	char descorer;
+	char match_loader;
+
+	// Cartridges
+	pros::MotorGear drive_gear;
+	pros::MotorGear conveyor_gear;
+	pros::MotorGear top_roller_gear;
+
+	// Drivetrain measurements. Until drive_measured is set, drive_gear and these
+	// are only estimates: the drive motors keep whatever cartridge setting they
+	// already have, and anything computed from these is approximate.
+	bool drive_measured;
+	double drive_ratio;        // wheel revs per motor rev (external gearing)
+	double wheel_diameter_in;
+	double track_width_in;     // center of left wheels to center of right wheels
+};
+
+namespace robot_config_check {
+
+constexpr std::uint8_t port_of(std::int8_t signed_port) {
+	return static_cast<std::uint8_t>(signed_port < 0 ? -signed_port : signed_port);
+}
+
+constexpr bool valid_smart_port(std::uint8_t port) { return port >= 1 && port <= 21; }
+
+constexpr bool valid_gear(pros::MotorGear gear) {
+	return gear == pros::MotorGear::red || gear == pros::MotorGear::green || gear == pros::MotorGear::blue;
+}
+
+constexpr bool smart_ports_ok(const RobotConfig& config) {
+	std::uint8_t ports[2 * DRIVE_MOTORS_PER_SIDE + 5] = {};
+	int n = 0;
+	for (std::int8_t port : config.left_drive) ports[n++] = port_of(port);
+	for (std::int8_t port : config.right_drive) ports[n++] = port_of(port);
+	ports[n++] = port_of(config.conveyor);
+	ports[n++] = port_of(config.top_roller);
+	for (std::uint8_t port : {config.block_sensor, config.block_camera, config.radio}) {
+		if (port != 0) ports[n++] = port;
+	}
+	for (int i = 0; i < n; i++) {
+		if (!valid_smart_port(ports[i])) return false;
+		for (int j = i + 1; j < n; j++) {
+			if (ports[i] == ports[j]) return false;
+		}
+	}
+	return true;
+}
+
+constexpr bool adi_ports_ok(const RobotConfig& config) {
+	auto valid = [](char port) { return (port >= 'A' && port <= 'H') || (port >= 'a' && port <= 'h'); };
+	auto upper = [](char port) { return port >= 'a' ? static_cast<char>(port - 'a' + 'A') : port; };
+	return valid(config.descorer) && valid(config.match_loader) && upper(config.descorer) != upper(config.match_loader);
+}
+
+constexpr bool gearing_ok(const RobotConfig& config) {
+	return valid_gear(config.drive_gear) && valid_gear(config.conveyor_gear) && valid_gear(config.top_roller_gear) &&
+	       config.drive_ratio > 0 && config.wheel_diameter_in > 0 && config.track_width_in > 0;
+}
+
+}  // namespace robot_config_check
+
+constexpr double cartridge_rpm(pros::MotorGear gear) {
+	return gear == pros::MotorGear::red ? 100.0 : gear == pros::MotorGear::green ? 200.0 : 600.0;
+}
+
+/**
+ * The drivetrain described by a RobotConfig.
+ *
+ * The measurements are all static constexpr, and both motor groups are built
+ * straight from the config's port arrays. The cartridge is only set on the
+ * motors once the config says the drive has been measured.
+ */
+template <const RobotConfig& Config>
+struct Drivetrain {
+	static constexpr double PI = 3.14159265358979323846;
+	static constexpr pros::MotorGear gearset = Config.drive_measured ? Config.drive_gear : pros::MotorGear::invalid;
+	static constexpr double wheel_circumference_in = PI * Config.wheel_diameter_in;
+	static constexpr double max_wheel_rpm = cartridge_rpm(Config.drive_gear) * Config.drive_ratio;
+	static constexpr double max_speed_in_per_s = max_wheel_rpm / 60.0 * wheel_circumference_in;
+
+	// Motor encoder degrees for the robot to travel one inch
+	static constexpr double motor_deg_per_in = 360.0 / (wheel_circumference_in * Config.drive_ratio);
+	// Motor encoder degrees on each side for the robot to turn one degree in place
+	static constexpr double motor_deg_per_turn_deg = PI * Config.track_width_in / 360.0 * motor_deg_per_in;
+
+	pros::MotorGroup left{{Config.left_drive[0], Config.left_drive[1], Config.left_drive[2]}, gearset};
+	pros::MotorGroup right{{Config.right_drive[0], Config.right_drive[1], Config.right_drive[2]}, gearset};
+
+	// The same motors one at a time, for code that needs to command each motor separately
+	pros::Motor left_motors[DRIVE_MOTORS_PER_SIDE] = {pros::Motor(Config.left_drive[0], gearset),
+	                                                  pros::Motor(Config.left_drive[1], gearset),
+	                                                  pros::Motor(Config.left_drive[2], gearset)};
+	pros::Motor right_motors[DRIVE_MOTORS_PER_SIDE] = {pros::Motor(Config.right_drive[0], gearset),
+	                                                   pros::Motor(Config.right_drive[1], gearset),
+	                                                   pros::Motor(Config.right_drive[2], gearset)};
+};
+
+static_assert(DRIVE_MOTORS_PER_SIDE == 3, "Drivetrain builds its motor groups from three ports per side");
+
+#endif  // _ROBOTCORE_ROBOT_CONFIG_HPP_
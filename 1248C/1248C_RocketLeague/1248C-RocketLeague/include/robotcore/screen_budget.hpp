@@ -0,0 +1,70 @@
+/**
+ * \file screen_budget.hpp
+ *
+ * Caps how much of the brain screen LVGL redraws per frame.
+ *
+ * Every refresh period LVGL redraws whatever was invalidated since
+ * the last frame, and a pros::lcd::print() every loop invalidates the whole
+ * label each time. Right before LVGL draws a frame this goes over the dirty
+ * areas:
+ *
+ * - Areas are merged when drawing the box around both costs no more than
+ *   drawing them separately, counting a fixed overhead per area for setting
+ *   up the draw and flushing it (MERGE_OVERHEAD_PX).
+ * - Areas are then drawn in order (anything waiting too long, normal
+ *   widgets, low priority widgets) until the frame's pixel budget is used.
+ *   The rest waits for the next frame. The first area is always drawn, so
+ *   the screen keeps moving even if one area is over the budget.
+ *
+ * Drawing time is close to proportional to pixels drawn, so the budget puts
+ * a ceiling on how long a frame can hold the CPU. Loading a new screen
+ * redraws the whole thing at once, budget or not.
+ *
+ * Mark widgets that can lag a frame or two, like charts, with
+ * set_priority(obj, Priority::low).
+ */
+
+#ifndef _ROBOTCORE_SCREEN_BUDGET_HPP_
+#define _ROBOTCORE_SCREEN_BUDGET_HPP_
+
+#include "liblvgl/lvgl.h"
+#include <cstdint>
+
+namespace screen_budget {
+
+constexpr std::uint32_t DEFAULT_PIXEL_BUDGET = 480 * 48;  // a fifth of the screen
+constexpr std::uint32_t MERGE_OVERHEAD_PX = 1500;         // what one more area costs, in pixels drawn
+constexpr std::uint32_t MAX_WAIT_FRAMES = 5;               // after this an area goes first
+constexpr int MAX_LOW_PRIORITY = 16;
+
+enum class Priority : std::uint8_t { normal, low };
+
+struct Stats {
+	std::uint32_t frames;
+	std::uint32_t pixels;           // total drawn
+	std::uint32_t max_pixels;       // most drawn in one frame
+	std::uint32_t merged;           // areas merged into another
+	std::uint32_t deferred;         // times an area was left for the next frame
+	std::uint32_t over_budget;      // frames where the first area alone was over the budget
+	std::uint32_t waiting;          // areas left for a later frame right now
+};
+
+/**
+ * Hooks into the default display. Call on the LVGL task after LVGL is up
+ * (pros::lcd::initialize()).
+ */
+void start(std::uint32_t pixel_budget = DEFAULT_PIXEL_BUDGET);
+
+void set_budget(std::uint32_t pixels);
+
+/**
+ * Areas entirely inside a low priority widget are drawn after everything
+ * else. Up to MAX_LOW_PRIORITY widgets; a deleted widget drops off by itself.
+ */
+void set_priority(lv_obj_t* obj, Priority priority);
+
+Stats stats();
+
+}  // namespace screen_budget
+
+#endif  // _ROBOTCORE_SCREEN_BUDGET_HPP_
@@ -0,0 +1,59 @@
+/**
+ * \file screen_mode.hpp
+ *
+ * How hard LVGL works on the brain screen, set from the competition state.
+ *
+ * During a match nobody is looking at the brain, but LVGL still redraws
+ * and reads the touch screen at full rate. Each competition function sets a
+ * mode on entry:
+ *
+ * - full: the rates LVGL started with. initialize(), disabled(),
+ *   competition_initialize(), and opcontrol() without a field connected.
+ * - minimal: a few redraws and touch reads a second. opcontrol() in a match.
+ * - frozen: no redraws and no touch at all. autonomous().
+ *
+ * Frozen turns off invalidation on the display, so widget changes are not
+ * even queued for drawing. Text printed while frozen still goes into the
+ * widgets; leaving frozen redraws the whole screen, so it shows up as soon
+ * as the mode goes back to full or minimal.
+ *
+ * The competition functions run in their own tasks and LVGL must only be
+ * touched from its own task, so set() just records the mode. A timer on the
+ * LVGL task applies it within APPLY_MS.
+ */
+
+#ifndef _ROBOTCORE_SCREEN_MODE_HPP_
+#define _ROBOTCORE_SCREEN_MODE_HPP_
+
+#include <cstdint>
+
+namespace screen_mode {
+
+enum class Mode : std::uint8_t { full, minimal, frozen };
+
+constexpr std::uint32_t MINIMAL_REFRESH_MS = 250;
+constexpr std::uint32_t MINIMAL_INPUT_MS = 250;
+constexpr std::uint32_t APPLY_MS = 50;
+
+/**
+ * Remembers LVGL's full rates and starts the timer that applies set().
+ * Call on the LVGL task after LVGL is up (pros::lcd::initialize()), like
+ * every other start() that builds on LVGL; initialize() runs them from a
+ * one-shot timer.
+ */
+void start();
+
+/**
+ * Asks for a mode. Only stores it, so any task can call it; the LVGL task
+ * changes the rates on its next pass of the apply timer.
+ */
+void set(Mode mode);
+
+/**
+ * The mode last asked for with set().
+ */
+Mode get();
+
+}  // namespace screen_mode
+
+#endif  // _ROBOTCORE_SCREEN_MODE_HPP_
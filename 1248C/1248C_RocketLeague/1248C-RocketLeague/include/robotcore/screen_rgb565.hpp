@@ -0,0 +1,53 @@
+/**
+ * \file screen_rgb565.hpp
+ *
+ * 16-bit color for the brain screen.
+ *
+ * lv_conf.h draws in 32-bit color, so every pixel LVGL fills, blends or
+ * flushes is four bytes. Building with `make SCREEN_RGB565=1` makes start()
+ * switch the display to RGB565 at run time: LVGL renders into our own
+ * 16-bit draw buffer (half the bytes to fill, blend and keep in cache), and
+ * our flush widens each area to the 32-bit pixels the V5 screen takes,
+ * FLUSH_LINES rows at a time. Normal builds leave the display alone.
+ *
+ * RGB565 keeps 32 levels of red and blue and 64 of green, so smooth color
+ * ramps show bands. The widening can't bring back the lost levels, but with
+ * dithering on it spreads each level over its range in a fixed 4x4 pattern,
+ * which breaks up the edges between bands. Black, white and any channel at
+ * 0 or full are left exact so text and flat UI colors stay clean.
+ *
+ * tools/lvgl_bench.cpp --rgb565 runs its screens in both profiles and
+ * reports the speed and the color error of each.
+ */
+
+#ifndef _ROBOTCORE_SCREEN_RGB565_HPP_
+#define _ROBOTCORE_SCREEN_RGB565_HPP_
+
+#include "liblvgl/lvgl.h"
+#include <cstdint>
+
+namespace screen_rgb565 {
+
+constexpr int DRAW_LINES = 40;   // rows of the 16-bit draw buffer, 38 KB
+constexpr int FLUSH_LINES = 8;   // rows widened per copy to the screen, 15 KB
+
+/**
+ * Switches the default display to RGB565 with our flush. Does nothing unless
+ * built with SCREEN_RGB565=1. Call on the LVGL task after
+ * pros::lcd::initialize().
+ */
+void start(bool dither = true);
+
+void set_dither(bool dither);
+
+/**
+ * Widens the RGB565 pixels of area (screen coordinates, so the dither pattern
+ * doesn't move between flushes) to XRGB8888. src_stride is in bytes,
+ * dest_stride in pixels.
+ */
+void expand(const std::uint8_t* src, std::uint32_t src_stride, std::uint32_t* dest, std::uint32_t dest_stride,
+            const lv_area_t& area, bool dither);
+
+}  // namespace screen_rgb565
+
+#endif  // _ROBOTCORE_SCREEN_RGB565_HPP_
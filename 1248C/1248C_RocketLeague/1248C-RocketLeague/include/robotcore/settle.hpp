@@ -0,0 +1,95 @@
+/**
+ * \file settle.hpp
+ *
+ * Stopping the drive between autonomous segments.
+ *
+ * stop() used to be move(0) and a fixed 50 ms wait, so how far the robot
+ * coasted depended on how fast it was going, and the next segment started
+ * from wherever it ended up. settle::stop() picks how to stop from the drive
+ * speed and what comes next:
+ *
+ * - Fast: reverse the drive for a moment (active braking) until the speed
+ *   is down, then let the brake mode finish the job.
+ * - A turn or an action (scoring, loading) next: HOLD, so the motors pull
+ *   back to where the stop started and the robot is where the plan says.
+ * - Another drive segment next, or already slow: BRAKE, which stops short
+ *   without fighting the next command.
+ *
+ * Then it waits, in closed loop on the motor velocities, until the drive has
+ * actually been still for a moment, instead of a fixed dwell. Every stop is
+ * logged with the time it took and how far the wheels moved after the stop
+ * began, so the dwell can be tuned from numbers.
+ */
+
+#ifndef _ROBOTCORE_SETTLE_HPP_
+#define _ROBOTCORE_SETTLE_HPP_
+
+#include <cstdint>
+
+namespace settle {
+
+enum class Next {
+	unknown,  // treated like a turn
+	drive,    // another straight segment
+	turn,
+	action,   // the robot has to stay put (scoring, loading, ...)
+};
+
+enum class Mode : std::uint8_t { coast, brake, hold };
+
+// These are here rather than in settle.cpp so tools/skills_planner.cpp can
+// model how long a stop takes.
+constexpr std::uint32_t LOOP_MS = 10;
+
+// Above FAST the drive is reversed until it is down to SLOW, for at most
+// ACTIVE_MAX_MS. Below SLOW a stop just brakes. Both are fractions of the
+// motors' full speed.
+constexpr double FAST_FRACTION = 0.35;
+constexpr double SLOW_FRACTION = 0.05;
+constexpr std::uint32_t ACTIVE_MAX_MS = 80;
+constexpr double ACTIVE_GAIN = 1.0;  // reverse command per unit of speed, as a fraction of full
+
+// Settled means every side under STILL_RPM for STILL_MS. TIMEOUT_MS bounds
+// how long a stop can take if something is pushing the robot.
+constexpr double STILL_RPM = 5;
+constexpr std::uint32_t STILL_MS = 30;
+constexpr std::uint32_t TIMEOUT_MS = 400;
+
+struct Result {
+	std::uint32_t settle_ms;   // from the stop call until the drive was still
+	double drift_deg;          // motor degrees the wheels moved after the stop began, average of both sides
+	double start_rpm;          // drive speed when the stop began
+	Mode mode;
+	bool active_brake;         // reversed the drive first
+	bool timed_out;            // never got still, gave up
+};
+
+/**
+ * Stops the drive and returns once it has settled.
+ */
+Result stop(Next next = Next::unknown);
+
+/**
+ * Puts the drive back in coast for driver control. Call at the start of
+ * opcontrol so HOLD from autonomous doesn't stiffen the sticks.
+ */
+void release();
+
+/**
+ * Number of stops logged since the last clear(), and the i-th one. Only the
+ * most recent LOG_SIZE are kept.
+ */
+constexpr int LOG_SIZE = 64;
+int count();
+Result get(int i);
+void clear();
+
+/**
+ * Prints the log on the serial console, one line per stop, then the worst
+ * and average settle time.
+ */
+void print();
+
+}  // namespace settle
+
+#endif  // _ROBOTCORE_SETTLE_HPP_
@@ -0,0 +1,58 @@
+/**
+ * \file spsc_queue.hpp
+ *
+ * Fixed size single-producer single-consumer queue.
+ *
+ * One task pushes and one other task pops. Neither side ever blocks or takes
+ * a mutex: push() fails when the queue is full and pop() fails when it is
+ * empty. Capacity must be a power of two.
+ */
+
+#ifndef _ROBOTCORE_SPSC_QUEUE_HPP_
+#define _ROBOTCORE_SPSC_QUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+	public:
+	/**
+	 * Adds an item. Producer side only.
+	 *
+	 * \return false if the queue was full and the item was dropped.
+	 */
+	bool push(const T& item) {
+		std::size_t head = write_index.load(std::memory_order_relaxed);
+		if (head - read_index.load(std::memory_order_acquire) == Capacity) return false;
+		items[head & (Capacity - 1)] = item;
+		write_index.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Takes the oldest item. Consumer side only.
+	 *
+	 * \return false if the queue was empty.
+	 */
+	bool pop(T& item) {
+		std::size_t tail = read_index.load(std::memory_order_relaxed);
+		if (tail == write_index.load(std::memory_order_acquire)) return false;
+		item = items[tail & (Capacity - 1)];
+		read_index.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	std::size_t size() const {
+		return write_index.load(std::memory_order_acquire) - read_index.load(std::memory_order_acquire);
+	}
+
+	private:
+	T items[Capacity];
+	std::atomic<std::size_t> write_index{0};
+	std::atomic<std::size_t> read_index{0};
+};
+
+#endif  // _ROBOTCORE_SPSC_QUEUE_HPP_
@@ -0,0 +1,69 @@
+/**
+ * \file stream_chart.hpp
+ *
+ * A chart for streaming telemetry that redraws only what changed.
+ *
+ * An lv_chart in shift mode moves every point one place left for each new
+ * value, and the whole chart is redrawn. A stream chart instead sweeps
+ * across like an oscilloscope: the newest column is written over the
+ * oldest one, so the rest of the chart doesn't move. push() only notes which
+ * columns changed; flush(), once per draw timer pass, invalidates them as one
+ * strip (two where the sweep wraps). Invalidating a strip per column would
+ * overflow LVGL's list of invalid areas at a couple of hundred samples per
+ * frame, and LVGL redraws the whole screen when that happens. GAP_COLUMNS
+ * blank columns ahead of the newest mark where the sweep is.
+ *
+ * Each pixel column is one column of samples_per_column samples, drawn as
+ * a vertical line from their minimum to their maximum. That way a 200 Hz
+ * motor current plot at display resolution still shows every spike. The
+ * columns are kept in an lv_circle_buf, so appending is constant time
+ * however wide the chart is.
+ */
+
+#ifndef _ROBOTCORE_STREAM_CHART_HPP_
+#define _ROBOTCORE_STREAM_CHART_HPP_
+
+#include "liblvgl/lvgl.h"
+#include <cstdint>
+#include <initializer_list>
+
+namespace stream_chart {
+
+constexpr int MAX_CHARTS = 4;
+constexpr int MAX_SERIES = 2;
+constexpr std::uint32_t GAP_COLUMNS = 4;
+
+/**
+ * A width x height chart from min to max with one pixel column per
+ * samples_per_column samples. Returns nullptr if there are already
+ * MAX_CHARTS; deleting a chart frees its place.
+ */
+lv_obj_t* create(lv_obj_t* parent, std::int32_t width, std::int32_t height, std::int32_t min, std::int32_t max,
+                 std::uint32_t samples_per_column = 1);
+
+/**
+ * Adds a series drawn in color, up to MAX_SERIES. Series are numbered in
+ * the order they are added.
+ */
+void add_series(lv_obj_t* chart, lv_color_t color);
+
+/**
+ * Adds one sample per series, in series order. Every samples_per_column
+ * calls a column is added. Nothing is redrawn until flush().
+ */
+void push(lv_obj_t* chart, std::initializer_list<std::int32_t> values);
+
+/**
+ * Invalidates every column pushed since the last flush(). Call once after
+ * each batch of push() calls, from the same timer.
+ */
+void flush(lv_obj_t* chart);
+
+/**
+ * Removes every column and any samples not drawn yet.
+ */
+void clear(lv_obj_t* chart);
+
+}  // namespace stream_chart
+
+#endif  // _ROBOTCORE_STREAM_CHART_HPP_
@@ -0,0 +1,90 @@
+/**
+ * \file task_monitor.hpp
+ *
+ * CPU share and stack headroom for our tasks.
+ *
+ * PROS doesn't expose the FreeRTOS run-time stats or stack high-water marks,
+ * so tasks report to the monitor themselves:
+ *
+ * - add() at the top of the task function registers it and fills the unused
+ *   part of its stack with a known pattern. The monitor finds the deepest the
+ *   stack has ever gone by looking for the first word that was overwritten.
+ * - task_monitor::delay_until()/delay() in place of the pros versions time
+ *   how long the task is awake between sleeps and count how often it wakes.
+ *   Each wake is a context switch into the task.
+ *
+ * Once a second a low priority task reads this along with each task's PROS
+ * state and priority. It prints a table on the serial console and the tightest
+ * task on brain screen line 3. The bookkeeping is two micros() reads per loop,
+ * and the stack scan only walks the stack the task has never used.
+ *
+ * Awake time counts time the task spent preempted, so it is an upper bound on
+ * its CPU share.
+ */
+
+#ifndef _ROBOTCORE_TASK_MONITOR_HPP_
+#define _ROBOTCORE_TASK_MONITOR_HPP_
+
+#include "pros/rtos.h"
+#include <cstdint>
+
+namespace task_monitor {
+
+constexpr int MAX_TASKS = 12;
+
+struct Stats {
+	const char* name;
+	std::uint32_t priority;
+	std::uint32_t state;       // pros::task_state_e_t
+	float cpu_percent;         // awake time over the last second
+	std::uint32_t wakes;       // context switches into the task over the last second
+	std::uint32_t stack_free;  // bytes never used, lower bound
+	std::uint32_t stack_size;  // bytes
+};
+
+/**
+ * Registers the calling task. Call first thing in the task function, with
+ * the stack depth the task was created with. The stack is painted from the
+ * caller's frame down, on the assumption that the task is no more than
+ * 8 KB deep here (see ENTRY_ALLOWANCE in task_monitor.cpp), so calling it
+ * from deep inside a task would paint past the end of its stack.
+ *
+ * A task that registers again under the same name (opcontrol after a
+ * re-enable) takes over its old slot. The slots of tasks that have been
+ * deleted are freed by the report task and reused.
+ *
+ * \return the id to pass to delay_until()/delay(), or -1 if the monitor is
+ * full. -1 is safe to pass; those calls then just delay.
+ */
+int add(const char* name, std::uint32_t stack_depth = TASK_STACK_DEPTH_DEFAULT);
+
+/**
+ * pros::Task::delay_until() that also times the task.
+ */
+void delay_until(int id, std::uint32_t* prev_time, std::uint32_t delta);
+
+/**
+ * pros::delay() that also times the task.
+ */
+void delay(int id, std::uint32_t ms);
+
+/**
+ * Starts the 1 Hz report task. Call once from initialize().
+ */
+void start();
+
+/**
+ * Turns the serial table on or off. It is on by default.
+ */
+void set_serial(bool enabled);
+
+/**
+ * Stats from the last report for task id.
+ *
+ * \return false if there is no such task yet.
+ */
+bool get(int id, Stats& stats);
+
+}  // namespace task_monitor
+
+#endif  // _ROBOTCORE_TASK_MONITOR_HPP_
@@ -0,0 +1,106 @@
+/**
+ * \file topic.hpp
+ *
+ * Lock-free latest-value topic for passing data between tasks.
+ *
+ * One task publishes, any number of tasks read the newest value. Nobody ever
+ * takes a mutex, so a low priority publisher can't hold up the control loop
+ * and there is no priority inversion.
+ *
+ * Values go round a small ring of slots, each with a sequence number that is
+ * odd while the slot is being written. publish() writes the slot after the
+ * newest one and then makes it the newest, so it never waits (wait-free).
+ * read() copies the newest slot and checks its sequence number didn't move;
+ * the only way it has to retry is if the publisher wrote the whole ring
+ * while the reader was copying. On the V5's single core that matters: a high
+ * priority reader that preempts a half-finished publish() just reads the
+ * previous slot instead of spinning on one the publisher can't finish.
+ *
+ * read_if_new() skips the copy entirely when nothing has been published since
+ * the caller's last read.
+ *
+ * T must be trivially copyable. There is no PROS dependency, so topics run
+ * unchanged on a computer.
+ */
+
+#ifndef _ROBOTCORE_TOPIC_HPP_
+#define _ROBOTCORE_TOPIC_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+template <typename T, std::size_t Slots = 4>
+class Topic {
+	static_assert(std::is_trivially_copyable_v<T>, "topics copy values with memcpy");
+	static_assert(Slots >= 2, "publish() needs a slot other than the one readers are on");
+
+	public:
+	/**
+	 * Makes value the newest. Publisher side only; one publisher per topic.
+	 */
+	void publish(const T& value) {
+		std::uint32_t next = published.load(std::memory_order_relaxed) + 1;
+		Slot& slot = slots[next % Slots];
+		std::uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+		slot.seq.store(seq + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		std::memcpy(&slot.value, &value, sizeof(T));
+		slot.seq.store(seq + 2, std::memory_order_release);
+		published.store(next, std::memory_order_release);
+	}
+
+	/**
+	 * Copies out the newest value.
+	 *
+	 * \return false if nothing has been published yet.
+	 */
+	bool read(T& out) const {
+		std::uint32_t version;
+		return copy_newest(out, version);
+	}
+
+	/**
+	 * Copies out the newest value if it is newer than last_version, and
+	 * updates last_version. Start last_version at 0.
+	 *
+	 * \return false, without copying, if there is nothing new.
+	 */
+	bool read_if_new(T& out, std::uint32_t& last_version) const {
+		if (published.load(std::memory_order_acquire) == last_version) return false;
+		return copy_newest(out, last_version);
+	}
+
+	/**
+	 * Number of values published so far.
+	 */
+	std::uint32_t version() const { return published.load(std::memory_order_acquire); }
+
+	private:
+	struct Slot {
+		std::atomic<std::uint32_t> seq{0};
+		T value;
+	};
+
+	bool copy_newest(T& out, std::uint32_t& version) const {
+		while (true) {
+			std::uint32_t newest = published.load(std::memory_order_acquire);
+			if (newest == 0) return false;
+			const Slot& slot = slots[newest % Slots];
+			std::uint32_t before = slot.seq.load(std::memory_order_acquire);
+			if (before & 1) continue;  // lapped: the publisher is rewriting this slot
+			std::memcpy(&out, &slot.value, sizeof(T));
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (slot.seq.load(std::memory_order_relaxed) == before) {
+				version = newest;
+				return true;
+			}
+		}
+	}
+
+	Slot slots[Slots];
+	std::atomic<std::uint32_t> published{0};
+};
+
+#endif  // _ROBOTCORE_TOPIC_HPP_
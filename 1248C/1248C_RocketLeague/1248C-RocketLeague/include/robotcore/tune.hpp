@@ -0,0 +1,56 @@
+/**
+ * \file tune.hpp
+ *
+ * Live tuning of gains and timing constants over the USB serial console.
+ *
+ * All tunable values live in one Params struct. There are two copies of it:
+ * the control code reads the front copy through tune::current(), and the
+ * console writes a change into the back copy and then swaps the two with one
+ * atomic pointer store. A control loop that grabs current() once per tick
+ * therefore always sees a complete, consistent set of values.
+ *
+ * Console commands (type into `pros terminal`, one per line):
+ *
+ *   list                 show every parameter
+ *   get <name>           show one parameter
+ *   set <name> <value>   change a parameter right away
+ *   save                 write all parameters to /usd/tune.txt
+ *   load                 read parameters back from /usd/tune.txt
+ */
+
+#ifndef _ROBOTCORE_TUNE_HPP_
+#define _ROBOTCORE_TUNE_HPP_
+
+namespace tune {
+
+struct Params {
+	double throttle_slew = 8;       // throttle change per 20 ms loop
+	double turn_deadband = 3;       // turn stick values at or below this are ignored
+	double turn_divisor = 2;        // turn stick is divided by this
+	double store_roller_speed = 55; // top roller speed while storing match loads
+};
+
+/**
+ * The parameters the control code should use right now.
+ *
+ * Read this once per loop and keep the reference for the rest of that loop.
+ */
+const Params& current();
+
+/**
+ * Starts the serial console task and loads /usd/tune.txt if there is one.
+ * Call once from initialize().
+ */
+void start();
+
+/**
+ * Changes one parameter by name, as the console's `set` does.
+ *
+ * \return false if there is no parameter with that name or the value is out
+ *         of range.
+ */
+bool set(const char* name, double value);
+
+}  // namespace tune
+
+#endif  // _ROBOTCORE_TUNE_HPP_
@@ -1,38 +1,35 @@
 #include "main.h"
+#include "robotcore/robot.hpp"
+#include "robotcore/color_sort.hpp"
+#include "robotcore/block_tracker.hpp"
+#include "robotcore/partner_link.hpp"
+#include "robotcore/tune.hpp"
+#include "robotcore/dashboard.hpp"
+#include "robotcore/motor_health.hpp"
+#include "robotcore/power_budget.hpp"
+#include "robotcore/ghost.hpp"
+#include "robotcore/task_monitor.hpp"
+#include "robotcore/heap_guard.hpp"
+#include "robotcore/settle.hpp"
+#include "robotcore/screen_budget.hpp"
+#include "robotcore/screen_mode.hpp"
+#include "robotcore/screen_rgb565.hpp"
+#include "robotcore/glyph_cache.hpp"
+#include "robotcore/lvgl_heap.hpp"
+#include "robotcore/image_assets.hpp"
+#include "robotcore/bindings.hpp"
 #include <algorithm>
+#include <atomic>
 #include <cstdlib>
 
-
-// Conveyor and top roller motors
-inline pros::Motor conveyor(20, pros::v5::MotorGear::green);
-inline pros::Motor top_roller(11, pros::v5::MotorGear::green);
-
-// Drivetrain motor groups (match opcontrol directions)
-inline pros::MotorGroup left_mg({16, 18, 17});
-inline pros::MotorGroup right_mg({13, 14, 12});
-
-/*  This is the original motor group so use this if the all positive one is not working. 
-	It appears that turning might not be working with auton. 
-inline pros::MotorGroup left_mg({-16, 18, 17});
-inline pros::MotorGroup right_mg({-13, -14, 12});
-*/
-
-// Conveyor control macros
-#define conveyor_on() conveyor.move(120)
-#define conveyor_off() conveyor.move(0)
-#define conveyor_reverse() conveyor.move(-120)
-
-// Top roller control macros
-#define top_roller_on() top_roller.move(-120)
-#define top_roller_off() top_roller.move(0)
-#define top_roller_reverse() top_roller.move(90)
 // autonomous movement helper + macros
 #define drive_ms(l, r, ms) do { left_mg.move(l); right_mg.move(r); pros::delay(ms); left_mg.move(0); right_mg.move(0); } while(0)
 #define turnright(speed, ms) drive_ms((speed), -(speed), (ms))
 #define turnleft(speed, ms) drive_ms(-(speed), (speed), (ms))
 #define forward(speed, ms) drive_ms((speed), (speed), (ms))
 #define backward(speed, ms) drive_ms(-(speed), -(speed), (ms))
-#define stop() do { left_mg.move(0); right_mg.move(0); pros::delay(50); } while(0)
+#define stop() settle::stop()  // brakes to a stop and waits until the drive is still
+#define stop_before(next) (settle::stop)(settle::Next::next)  // same, when the next move is known (drive, turn, action)
 #define score() do { top_roller_on(); pros::delay(300); top_roller_off(); } while(0)
 #define jiggle() do { left_mg.move(-50); right_mg.move(-50); pros::delay(100); left_mg.move(50); right_mg.move(50); pros::delay(100); } while(0)
 #define lower_match_loader() do { match_loader_solenoid.set_value(true); pros::delay(100); } while(0)
@@ -62,7 +59,7 @@ inline pros::MotorGroup right_mg({-13, -14, 12});
 		forward(100, 50); \
 		stop(); \
 		turnleft(100, 90); \
-		stop(); \
+		stop_before(drive); \
 		forward(100, 500); \
 		stop(); \
 		turnleft(100, 90); \
@@ -72,20 +69,50 @@ inline pros::MotorGroup right_mg({-13, -14, 12});
 		turnleft(100, 90);} while(0)
 	
 #define traverse_match_load() do {turnright(90, 90); \
-		stop(); \
+		stop_before(drive); \
 		forward(90, 500); \
 		stop();\
 		turnleft(90, 90);} while(0)
 
-// Match loader solenoids (ports G and H)
-pros::ADIDigitalOut descorer('G');
-pros::ADIDigitalOut match_loader_solenoid('H');
-
-// Turn both on
-#define intake_on() do { conveyor_on(); top_roller_on(); } while(0)
+/**
+ * Drives to a loose block seen by the AI Vision sensor and intakes it.
+ *
+ * Steers toward the tracked block with the intake running until the block is
+ * close enough to be in the intake, then drives a little further to pull it in.
+ * Gives up if no block is in view or the timeout runs out.
+ *
+ * \return true if a block was reached.
+ */
+bool pickup_block(std::uint32_t timeout_ms) {
+	constexpr double STEER_GAIN = 2.0;     // motor units per degree of heading error
+	constexpr double PICKUP_SIZE = 0.25;   // block fills this much of the image when it is at the intake
+	constexpr int APPROACH_SPEED = 60;
+
+	std::uint32_t start = pros::millis();
+	block_tracker::Target target;
+	bool reached = false;
+
+	intake_on();
+	while (pros::millis() - start < timeout_ms && block_tracker::get_target(target)) {
+		if (target.size >= PICKUP_SIZE) {
+			reached = true;
+			break;
+		}
+		int steer = static_cast<int>(target.heading_deg * STEER_GAIN);
+		left_mg.move(APPROACH_SPEED + steer);
+		right_mg.move(APPROACH_SPEED - steer);
+		pros::delay(20);
+	}
+	if (reached) {
+		forward(APPROACH_SPEED, 200);
+	}
+	stop();
+	conveyor_off();
+	top_roller_off();
+	return reached;
+}
 
-// Store match loads (conveyor on, top roller in reverse at half speed)
-#define store_match_load() do { conveyor.move(120); top_roller.move(55); } while(0)
+constexpr std::uint32_t PICKUP_TIMEOUT_MS = 2000;  // longest autonomous spends chasing a loose block
 
 // A simple autonomous function that drives forward for a short time
 void skeleton_auto() {
@@ -118,10 +145,15 @@ void skeleton_auto() {
 	turnright(90, 90);
 	stop();
 	forward(90, 200);
+	stop();
 
-	
+	pickup_block(PICKUP_TIMEOUT_MS);  // Use the time left on a loose block of our color, if one is in view
 }
 
+// Set to true to replay the last driver run recorded with Y in opcontrol
+// instead of skeleton_auto. Falls back to skeleton_auto if there is no recording.
+constexpr bool USE_GHOST_AUTO = false;
+
 /**
  * A callback function for LLEMU's center button.
  *
@@ -138,6 +170,54 @@ void on_center_button() {
 	}
 }
 
+/**
+ * Sets the alliance color the sorter keeps and shows it on line 5. Sorting
+ * stays off (Alliance::none) until an alliance is picked here.
+ */
+static void select_alliance(color_sort::Alliance alliance) {
+	static const char* const NAMES[] = {"none (no sorting)", "red", "blue"};
+	color_sort::set_alliance(alliance);
+	pros::lcd::print(5, "Alliance: %s", NAMES[static_cast<int>(alliance)]);
+}
+
+/**
+ * Left LLEMU button: steps the alliance through none, red and blue.
+ */
+void on_left_button() {
+	select_alliance(static_cast<color_sort::Alliance>((static_cast<int>(color_sort::alliance()) + 1) % 3));
+}
+
+static int lcd_buttons = -1;  // bindings subject with the LLEMU button bits
+
+/**
+ * Prints the LLEMU button states on line 0. Runs on the LVGL task, and only
+ * when one of them changed.
+ */
+static void show_buttons(lv_obj_t*, std::int32_t buttons) {
+	pros::lcd::print(0, "%d %d %d", (buttons & LCD_BTN_LEFT) >> 2, (buttons & LCD_BTN_CENTER) >> 1,
+	                 (buttons & LCD_BTN_RIGHT) >> 0);
+}
+
+static std::atomic<bool> screens_built = false;
+
+/**
+ * Sets up everything drawn on the brain screen. LVGL must only be touched
+ * from its own task, and initialize() runs in another, so initialize() hands
+ * this to a one-shot LVGL timer and waits for it.
+ */
+static void build_screens(lv_timer_t*) {
+	screen_rgb565::start();  // only in SCREEN_RGB565=1 builds
+	screen_budget::start();
+	image_assets::start();
+	screen_mode::start();
+	glyph_cache::attach(lv_screen_active());  // LLEMU text
+	bindings::start();
+	lcd_buttons = bindings::subject();
+	bindings::bind(lcd_buttons, nullptr, show_buttons);
+	dashboard::start();
+	screens_built.store(true);
+}
+
 /**
  * Runs initialization code. This occurs as soon as the program is started.
  *
@@ -148,7 +228,23 @@ void initialize() {
 	pros::lcd::initialize();
 	pros::lcd::set_text(1, "Rayed FTW");
 
+	pros::lcd::register_btn0_cb(on_left_button);
 	pros::lcd::register_btn1_cb(on_center_button);
+	lv_timer_t* setup = lv_timer_create(build_screens, 0, nullptr);
+	lv_timer_set_repeat_count(setup, 1);
+	while (!screens_built.load()) pros::delay(5);  // the LVGL task runs it on its next pass
+
+	task_monitor::start();
+	tune::start();
+
+	color_sort::start(color_sort::Alliance::none);
+	select_alliance(color_sort::Alliance::none);  // Picked before the match, see competition_initialize()
+	block_tracker::start();
+	partner::start(robot_config.link_transmitter);
+	motor_health::start();
+	ghost::start();
+
+	heap_guard::seal();  // Nothing allocates from here on
 }
 
 /**
@@ -156,7 +252,10 @@ void initialize() {
  * the VEX Competition Switch, following either autonomous or opcontrol. When
  * the robot is enabled, this task will exit.
  */
-void disabled() {}
+void disabled() {
+	screen_mode::set(screen_mode::Mode::full);
+	lvgl_heap::print();  // after each period of a match, on the serial console
+}
 
 /**
  * Runs after initialize(), and before autonomous when connected to the Field
@@ -167,7 +266,19 @@ void disabled() {}
  * This task will exit when the robot is enabled and autonomous or opcontrol
  * starts.
  */
-void competition_initialize() {}
+void competition_initialize() {
+	screen_mode::set(screen_mode::Mode::full);
+
+	// Alliance for the color sorter: left arrow red, right arrow blue, down
+	// arrow none. The left LLEMU button does the same from the brain.
+	pros::Controller master(pros::E_CONTROLLER_MASTER);
+	while (true) {
+		if (master.get_digital_new_press(DIGITAL_LEFT)) select_alliance(color_sort::Alliance::red);
+		if (master.get_digital_new_press(DIGITAL_RIGHT)) select_alliance(color_sort::Alliance::blue);
+		if (master.get_digital_new_press(DIGITAL_DOWN)) select_alliance(color_sort::Alliance::none);
+		pros::delay(20);
+	}
+}
 
 /**
  * Runs the user autonomous code. This function will be started in its own task
@@ -181,7 +292,11 @@ void competition_initialize() {}
  * from where it left off.
  */
 void autonomous() {
-	skeleton_auto();
+	screen_mode::set(screen_mode::Mode::frozen);  // Nobody is watching the brain
+	if (!USE_GHOST_AUTO || !ghost::play()) {
+		skeleton_auto();
+	}
+	settle::print();  // Settle time for every stop, to tune against
 }
 
 /**
@@ -198,7 +313,9 @@ void autonomous() {
  * task, not resume it from where it left off.
  */
 void opcontrol() {
-	
+	int monitor_id = task_monitor::add("opcontrol");
+	// Full screen on the bench, just enough to glance at in a match
+	screen_mode::set(pros::competition::is_connected() ? screen_mode::Mode::minimal : screen_mode::Mode::full);
 	pros::Controller master(pros::E_CONTROLLER_MASTER);
 
 	// State variables for toggles
@@ -211,12 +328,22 @@ void opcontrol() {
 
 	match_loader_solenoid.set_value(false);
 	descorer.set_value(false);
+	settle::release();  // Autonomous may have left the drive in hold
 
+	std::uint64_t last_tick_us = pros::micros();
 
 	while (true) {
-		pros::lcd::print(0, "%d %d %d", (pros::lcd::read_buttons() & LCD_BTN_LEFT) >> 2,
-	 	                 (pros::lcd::read_buttons() & LCD_BTN_CENTER) >> 1,
-	 	                 (pros::lcd::read_buttons() & LCD_BTN_RIGHT) >> 0);  // Prints status of the emulated screen LCDs
+		// Send this tick's telemetry to the dashboard
+		std::uint64_t tick_us = pros::micros();
+		dashboard::Sample sample;
+		dashboard::read_robot(sample);
+		sample.loop_jitter_us = std::clamp<std::int64_t>(tick_us - last_tick_us - 20000, 0, INT16_MAX);
+		last_tick_us = tick_us;
+		dashboard::push(sample);
+
+		bindings::publish(lcd_buttons, pros::lcd::read_buttons());  // Status of the emulated screen LCDs, shown on change
+
+		const tune::Params& params = tune::current();  // One consistent set of tuned values per loop
 
 	 	// Rocket League driving control scheme
 		static int current_throttle = 0;  // Track previous throttle value
@@ -225,19 +352,19 @@ void opcontrol() {
 
 		// Smoothly ramp to target
 		if (current_throttle < target_throttle) {
-			current_throttle += 8;  // Accelerate up
+			current_throttle += params.throttle_slew;  // Accelerate up
 			if (current_throttle > target_throttle) current_throttle = target_throttle;
 		} else if (current_throttle > target_throttle) {
-			current_throttle -= 8;  // Decelerate/reverse smoothly
+			current_throttle -= params.throttle_slew;  // Decelerate/reverse smoothly
 			if (current_throttle < target_throttle) current_throttle = target_throttle;
 		}
 
 		int throttle = current_throttle;
 		int turn = master.get_analog(ANALOG_LEFT_X);   // Left joystick X for turning
 		int conveyor_speed = master.get_analog(ANALOG_RIGHT_Y);  // Right joystick Y for conveyor
-		turn /= 2;  // Reduces turn value for easier control
+		turn /= params.turn_divisor;  // Reduces turn value for easier control
 
-		if (std::abs(turn) <= 3) {
+		if (std::abs(turn) <= params.turn_deadband) {
 			turn = 0;  // Deadband to prevent drift when driving straight
 		}
 
@@ -252,17 +379,26 @@ void opcontrol() {
 			right = static_cast<int>(right * scale);
 		}
 
-		left_mg.move(left);
-		right_mg.move(right);
+		power::Commands wanted = {left, right, 0, 0};
 		if (match_load_enabled) {
-			store_match_load();
+			wanted.conveyor = CONVEYOR_SPEED;   // Same as store_match_load()
+			wanted.top_roller = params.store_roller_speed;
 		} else if (shoot_enabled) {
-			intake_on();
+			wanted.conveyor = CONVEYOR_SPEED;   // Same as intake_on()
+			wanted.top_roller = TOP_ROLLER_SPEED;
 		} else {
-			conveyor.move(conveyor_speed);      // Conveyor controlled by right joystick
-			top_roller_off();
+			wanted.conveyor = conveyor_speed;   // Conveyor controlled by right joystick
+		}
+		if (color_sort::ejecting()) {
+			wanted.top_roller = TOP_ROLLER_REVERSE_SPEED;  // Color sorter owns the top roller while throwing a block out
 		}
 
+		// Fit everything into what the battery can give this tick
+		power::Commands out = power::allocate(wanted);
+		motor_health::move_drive(out.left, out.right);  // Shifts load off any drive motor close to its heat limit
+		conveyor.move(out.conveyor);
+		move_top_roller(out.top_roller);
+
 		//B: Loading toggle - Toggle on/off
 	 	if (master.get_digital_new_press(DIGITAL_B)) {
 	 		match_load_enabled = !match_load_enabled;
@@ -290,6 +426,23 @@ void opcontrol() {
 			descorer_enabled = !descorer_enabled;
 			descorer.set_value(descorer_enabled);
 		}
-	 	pros::delay(20);  // Run for 20 ms then update
+
+		// Y: Start/stop recording this run for ghost::play()
+		if (master.get_digital_new_press(DIGITAL_Y)) {
+			if (ghost::recording()) {
+				ghost::end_recording();
+				master.rumble("-");
+			} else if (ghost::begin_recording()) {
+				master.rumble(".");
+			} else {
+				master.rumble("..");  // No SD card, or the last recording is still being saved
+			}
+		}
+		ghost::Frame frame = {pros::millis(), out.left, out.right, out.conveyor, out.top_roller,
+		                      left_mg.get_position(), right_mg.get_position(),
+		                      static_cast<std::uint8_t>((descorer_enabled ? ghost::DESCORER_BIT : 0) |
+		                                                (match_loader_solenoid_enable ? ghost::MATCH_LOADER_BIT : 0))};
+		ghost::record(frame);
+	 	task_monitor::delay(monitor_id, 20);  // Run for 20 ms then update
 	 }
 }
@@ -0,0 +1,147 @@
+#include "robotcore/bindings.hpp"
+#include <atomic>
+#include <cstdlib>
+
+namespace bindings {
+
+struct Value {
+	std::atomic<std::int32_t> staged;  // last publish(), from any task
+	lv_subject_t subject;              // what the widgets see, LVGL task only
+};
+
+struct Binding {
+	bool used;
+	int subject;
+	lv_obj_t* obj;
+	Apply apply;
+	const char* format;       // labels only
+	std::int32_t threshold;
+	std::uint32_t min_period_ms;
+	bool shown_any;
+	std::int32_t shown;
+	std::uint32_t shown_ms;
+	bool waiting;             // a change is held back by min_period_ms
+};
+
+static Value values[MAX_SUBJECTS];
+static int value_count = 0;
+static Binding links[MAX_BINDINGS];
+static Stats totals = {};
+
+static void show(Binding& link, std::int32_t value) {
+	if (link.format != nullptr) {
+		lv_label_set_text_fmt(link.obj, link.format, static_cast<int>(value));
+	} else {
+		link.apply(link.obj, value);
+	}
+	link.shown_any = true;
+	link.shown = value;
+	link.shown_ms = lv_tick_get();
+	link.waiting = false;
+	totals.applied++;
+}
+
+static void offer(Binding& link, std::int32_t value) {
+	if (link.shown_any) {
+		std::int64_t moved = std::llabs(static_cast<std::int64_t>(value) - link.shown);
+		if (moved < link.threshold) {
+			if (moved > 0) totals.filtered++;
+			link.waiting = false;  // back within threshold of what is shown
+			return;
+		}
+		if (lv_tick_elaps(link.shown_ms) < link.min_period_ms) {
+			if (!link.waiting) totals.deferred++;
+			link.waiting = true;
+			return;
+		}
+	}
+	show(link, value);
+}
+
+static void on_change(lv_observer_t* observer, lv_subject_t* subject) {
+	offer(*static_cast<Binding*>(lv_observer_get_user_data(observer)), lv_subject_get_int(subject));
+}
+
+static void on_delete(lv_event_t* event) {
+	*static_cast<Binding*>(lv_event_get_user_data(event)) = {};
+}
+
+static void set_bar(lv_obj_t* bar, std::int32_t value) { lv_bar_set_value(bar, value, LV_ANIM_OFF); }
+
+static void add(int subject, lv_obj_t* obj, Apply apply, const char* format, std::int32_t threshold,
+                std::uint32_t min_period_ms) {
+	if (subject < 0 || subject >= value_count) return;
+	for (Binding& link : links) {
+		if (link.used) continue;
+		link = {};
+		link.used = true;
+		link.subject = subject;
+		link.obj = obj;
+		link.apply = apply;
+		link.format = format;
+		link.threshold = threshold > 0 ? threshold : 1;
+		link.min_period_ms = min_period_ms;
+		// Adding an observer calls it once, which shows the current value.
+		if (obj == nullptr) {
+			lv_subject_add_observer(&values[subject].subject, on_change, &link);
+		} else {
+			lv_obj_add_event_cb(obj, on_delete, LV_EVENT_DELETE, &link);
+			lv_subject_add_observer_obj(&values[subject].subject, on_change, obj, &link);
+		}
+		return;
+	}
+}
+
+static void sync_timer(lv_timer_t*) { sync(); }
+
+void start() {
+	static lv_timer_t* timer = nullptr;
+	if (timer == nullptr) timer = lv_timer_create(sync_timer, SYNC_PERIOD_MS, nullptr);
+}
+
+int subject(std::int32_t initial) {
+	if (value_count == MAX_SUBJECTS) return -1;
+	Value& value = values[value_count];
+	value.staged.store(initial, std::memory_order_relaxed);
+	lv_subject_init_int(&value.subject, initial);
+	return value_count++;
+}
+
+void publish(int subject, std::int32_t value) {
+	if (subject < 0 || subject >= value_count) return;
+	values[subject].staged.store(value, std::memory_order_relaxed);
+}
+
+void bind(int subject, lv_obj_t* obj, Apply apply, std::int32_t threshold, std::uint32_t min_period_ms) {
+	if (apply != nullptr) add(subject, obj, apply, nullptr, threshold, min_period_ms);
+}
+
+void bind_label(int subject, lv_obj_t* label, const char* format, std::int32_t threshold,
+                std::uint32_t min_period_ms) {
+	if (label != nullptr && format != nullptr) add(subject, label, nullptr, format, threshold, min_period_ms);
+}
+
+void bind_bar(int subject, lv_obj_t* bar, std::int32_t threshold, std::uint32_t min_period_ms) {
+	if (bar != nullptr) add(subject, bar, set_bar, nullptr, threshold, min_period_ms);
+}
+
+lv_subject_t* get(int subject) {
+	if (subject < 0 || subject >= value_count) return nullptr;
+	return &values[subject].subject;
+}
+
+void sync() {
+	for (int i = 0; i < value_count; i++) {
+		std::int32_t staged = values[i].staged.load(std::memory_order_relaxed);
+		if (staged == lv_subject_get_int(&values[i].subject)) continue;
+		totals.changes++;
+		lv_subject_set_int(&values[i].subject, staged);  // notifies the bindings
+	}
+	for (Binding& link : links) {
+		if (link.used && link.waiting) offer(link, lv_subject_get_int(&values[link.subject].subject));
+	}
+}
+
+Stats stats() { return totals; }
+
+}  // namespace bindings
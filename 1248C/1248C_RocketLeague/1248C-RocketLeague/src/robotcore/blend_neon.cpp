@@ -0,0 +1,210 @@
+#include "robotcore/blend_neon.h"
+#include <cstdint>
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// lv_color_mix32() from lv_color_op.c.
+static inline lv_color32_t mix(lv_color32_t fg, lv_color32_t bg) {
+	if (fg.alpha >= LV_OPA_MAX) {
+		fg.alpha = bg.alpha;
+		return fg;
+	}
+	if (fg.alpha <= LV_OPA_MIN) return bg;
+	bg.red = (static_cast<std::uint32_t>(fg.red) * fg.alpha + static_cast<std::uint32_t>(bg.red) * (255 - fg.alpha)) >> 8;
+	bg.green =
+	    (static_cast<std::uint32_t>(fg.green) * fg.alpha + static_cast<std::uint32_t>(bg.green) * (255 - fg.alpha)) >> 8;
+	bg.blue =
+	    (static_cast<std::uint32_t>(fg.blue) * fg.alpha + static_cast<std::uint32_t>(bg.blue) * (255 - fg.alpha)) >> 8;
+	return bg;
+}
+
+// lv_color_32_32_mix() from lv_draw_sw_blend_to_argb8888.c, without the
+// cache, which only saves recomputing the same answer.
+static inline lv_color32_t mix_alpha(lv_color32_t fg, lv_color32_t bg) {
+	if (fg.alpha >= LV_OPA_MAX || bg.alpha <= LV_OPA_MIN) return fg;
+	if (fg.alpha <= LV_OPA_MIN) return bg;
+	if (bg.alpha == 255) return mix(fg, bg);
+	lv_opa_t res_alpha = 255 - LV_OPA_MIX2(255 - fg.alpha, 255 - bg.alpha);
+	fg.alpha = static_cast<std::uint32_t>(fg.alpha) * 255 / res_alpha;
+	lv_color32_t res = mix(fg, bg);
+	res.alpha = res_alpha;
+	return res;
+}
+
+static inline lv_color32_t to_color32(lv_color_t color, lv_opa_t opa) {
+	lv_color32_t out;
+	out.blue = color.blue;
+	out.green = color.green;
+	out.red = color.red;
+	out.alpha = opa;
+	return out;
+}
+
+static inline lv_color32_t* row(void* buf, std::int32_t stride, std::int32_t y) {
+	return reinterpret_cast<lv_color32_t*>(static_cast<std::uint8_t*>(buf) + y * stride);
+}
+
+static inline const lv_color32_t* row(const void* buf, std::int32_t stride, std::int32_t y) {
+	return reinterpret_cast<const lv_color32_t*>(static_cast<const std::uint8_t*>(buf) + y * stride);
+}
+
+void blend_reference_color_to_argb8888(lv_draw_sw_blend_fill_dsc_t* dsc) {
+	lv_color32_t color = to_color32(dsc->color, 255);
+	for (std::int32_t y = 0; y < dsc->dest_h; y++) {
+		lv_color32_t* dest = row(dsc->dest_buf, dsc->dest_stride, y);
+		for (std::int32_t x = 0; x < dsc->dest_w; x++) dest[x] = color;
+	}
+}
+
+void blend_reference_color_to_argb8888_with_opa(lv_draw_sw_blend_fill_dsc_t* dsc) {
+	lv_color32_t color = to_color32(dsc->color, dsc->opa);
+	for (std::int32_t y = 0; y < dsc->dest_h; y++) {
+		lv_color32_t* dest = row(dsc->dest_buf, dsc->dest_stride, y);
+		for (std::int32_t x = 0; x < dsc->dest_w; x++) dest[x] = mix_alpha(color, dest[x]);
+	}
+}
+
+void blend_reference_argb8888_to_argb8888(lv_draw_sw_blend_image_dsc_t* dsc) {
+	for (std::int32_t y = 0; y < dsc->dest_h; y++) {
+		lv_color32_t* dest = row(dsc->dest_buf, dsc->dest_stride, y);
+		const lv_color32_t* src = row(dsc->src_buf, dsc->src_stride, y);
+		for (std::int32_t x = 0; x < dsc->dest_w; x++) dest[x] = mix_alpha(src[x], dest[x]);
+	}
+}
+
+void blend_reference_argb8888_to_argb8888_with_opa(lv_draw_sw_blend_image_dsc_t* dsc) {
+	for (std::int32_t y = 0; y < dsc->dest_h; y++) {
+		lv_color32_t* dest = row(dsc->dest_buf, dsc->dest_stride, y);
+		const lv_color32_t* src = row(dsc->src_buf, dsc->src_stride, y);
+		for (std::int32_t x = 0; x < dsc->dest_w; x++) {
+			lv_color32_t color = src[x];
+			color.alpha = LV_OPA_MIX2(color.alpha, dsc->opa);
+			dest[x] = mix_alpha(color, dest[x]);
+		}
+	}
+}
+
+#if defined(__ARM_NEON)
+
+// False if any of the 8 pixels needs the divide, which is when both the
+// foreground and the background are partly transparent.
+static inline bool all_simple(uint8x8_t fg_alpha, uint8x8_t bg_alpha) {
+	uint8x8_t fg_partial = vand_u8(vcgt_u8(fg_alpha, vdup_n_u8(LV_OPA_MIN)), vclt_u8(fg_alpha, vdup_n_u8(LV_OPA_MAX)));
+	uint8x8_t bg_partial = vand_u8(vcgt_u8(bg_alpha, vdup_n_u8(LV_OPA_MIN)), vclt_u8(bg_alpha, vdup_n_u8(255)));
+	return vget_lane_u64(vreinterpret_u64_u8(vand_u8(fg_partial, bg_partial)), 0) == 0;
+}
+
+// mix_alpha() on 8 pixels that all_simple() passed, planes in memory order
+// (blue, green, red, alpha).
+static inline uint8x8x4_t mix_simple(uint8x8x4_t fg, uint8x8x4_t bg) {
+	uint8x8_t fg_alpha = fg.val[3];
+	uint8x8_t bg_alpha = bg.val[3];
+	uint8x8_t take_fg = vorr_u8(vcge_u8(fg_alpha, vdup_n_u8(LV_OPA_MAX)), vcle_u8(bg_alpha, vdup_n_u8(LV_OPA_MIN)));
+	uint8x8_t take_bg = vbic_u8(vcle_u8(fg_alpha, vdup_n_u8(LV_OPA_MIN)), take_fg);
+	uint8x8_t fg_inverse = vmvn_u8(fg_alpha);  // 255 - alpha
+	uint8x8x4_t out;
+	for (int c = 0; c < 3; c++) {
+		uint16x8_t sum = vmlal_u8(vmull_u8(fg.val[c], fg_alpha), bg.val[c], fg_inverse);
+		uint8x8_t mixed = vshrn_n_u16(sum, 8);
+		out.val[c] = vbsl_u8(take_fg, fg.val[c], vbsl_u8(take_bg, bg.val[c], mixed));
+	}
+	// Otherwise the background was opaque and stays that way.
+	out.val[3] = vbsl_u8(take_fg, fg_alpha, bg_alpha);
+	return out;
+}
+
+static inline uint8x8x4_t splat(lv_color32_t color) {
+	uint8x8x4_t out;
+	out.val[0] = vdup_n_u8(color.blue);
+	out.val[1] = vdup_n_u8(color.green);
+	out.val[2] = vdup_n_u8(color.red);
+	out.val[3] = vdup_n_u8(color.alpha);
+	return out;
+}
+
+lv_result_t blend_neon_color_to_argb8888(lv_draw_sw_blend_fill_dsc_t* dsc) {
+	lv_color32_t color = to_color32(dsc->color, 255);
+	std::uint32_t value;
+	__builtin_memcpy(&value, &color, sizeof(value));
+	uint32x4_t quad = vdupq_n_u32(value);
+	for (std::int32_t y = 0; y < dsc->dest_h; y++) {
+		std::uint32_t* dest = reinterpret_cast<std::uint32_t*>(row(dsc->dest_buf, dsc->dest_stride, y));
+		std::int32_t x = 0;
+		for (; x + 8 <= dsc->dest_w; x += 8) {
+			vst1q_u32(dest + x, quad);
+			vst1q_u32(dest + x + 4, quad);
+		}
+		for (; x < dsc->dest_w; x++) dest[x] = value;
+	}
+	return LV_RESULT_OK;
+}
+
+lv_result_t blend_neon_color_to_argb8888_with_opa(lv_draw_sw_blend_fill_dsc_t* dsc) {
+	lv_color32_t color = to_color32(dsc->color, dsc->opa);
+	uint8x8x4_t fg = splat(color);
+	for (std::int32_t y = 0; y < dsc->dest_h; y++) {
+		lv_color32_t* dest = row(dsc->dest_buf, dsc->dest_stride, y);
+		std::int32_t x = 0;
+		for (; x + 8 <= dsc->dest_w; x += 8) {
+			std::uint8_t* bytes = reinterpret_cast<std::uint8_t*>(dest + x);
+			uint8x8x4_t bg = vld4_u8(bytes);
+			if (all_simple(fg.val[3], bg.val[3])) {
+				vst4_u8(bytes, mix_simple(fg, bg));
+			} else {
+				for (int i = 0; i < 8; i++) dest[x + i] = mix_alpha(color, dest[x + i]);
+			}
+		}
+		for (; x < dsc->dest_w; x++) dest[x] = mix_alpha(color, dest[x]);
+	}
+	return LV_RESULT_OK;
+}
+
+// Shared by the two image blends. Without scale the source alpha is used as is.
+static inline void blend_image(lv_draw_sw_blend_image_dsc_t* dsc, bool scale, lv_opa_t opa) {
+	uint8x8_t opa_plane = vdup_n_u8(opa);
+	for (std::int32_t y = 0; y < dsc->dest_h; y++) {
+		lv_color32_t* dest = row(dsc->dest_buf, dsc->dest_stride, y);
+		const lv_color32_t* src = row(dsc->src_buf, dsc->src_stride, y);
+		std::int32_t x = 0;
+		for (; x + 8 <= dsc->dest_w; x += 8) {
+			std::uint8_t* dest_bytes = reinterpret_cast<std::uint8_t*>(dest + x);
+			uint8x8x4_t fg = vld4_u8(reinterpret_cast<const std::uint8_t*>(src + x));
+			uint8x8x4_t bg = vld4_u8(dest_bytes);
+			if (scale) fg.val[3] = vshrn_n_u16(vmull_u8(fg.val[3], opa_plane), 8);  // LV_OPA_MIX2
+			if (all_simple(fg.val[3], bg.val[3])) {
+				vst4_u8(dest_bytes, mix_simple(fg, bg));
+				continue;
+			}
+			for (int i = 0; i < 8; i++) {
+				lv_color32_t color = src[x + i];
+				if (scale) color.alpha = LV_OPA_MIX2(color.alpha, opa);
+				dest[x + i] = mix_alpha(color, dest[x + i]);
+			}
+		}
+		for (; x < dsc->dest_w; x++) {
+			lv_color32_t color = src[x];
+			if (scale) color.alpha = LV_OPA_MIX2(color.alpha, opa);
+			dest[x] = mix_alpha(color, dest[x]);
+		}
+	}
+}
+
+lv_result_t blend_neon_argb8888_to_argb8888(lv_draw_sw_blend_image_dsc_t* dsc) {
+	blend_image(dsc, false, 255);
+	return LV_RESULT_OK;
+}
+
+lv_result_t blend_neon_argb8888_to_argb8888_with_opa(lv_draw_sw_blend_image_dsc_t* dsc) {
+	blend_image(dsc, true, dsc->opa);
+	return LV_RESULT_OK;
+}
+
+#else
+
+lv_result_t blend_neon_color_to_argb8888(lv_draw_sw_blend_fill_dsc_t*) { return LV_RESULT_INVALID; }
+lv_result_t blend_neon_color_to_argb8888_with_opa(lv_draw_sw_blend_fill_dsc_t*) { return LV_RESULT_INVALID; }
+lv_result_t blend_neon_argb8888_to_argb8888(lv_draw_sw_blend_image_dsc_t*) { return LV_RESULT_INVALID; }
+lv_result_t blend_neon_argb8888_to_argb8888_with_opa(lv_draw_sw_blend_image_dsc_t*) { return LV_RESULT_INVALID; }
+
+#endif
@@ -0,0 +1,163 @@
+#include "robotcore/block_tracker.hpp"
+#include "robotcore/color_sort.hpp"
+#include "robotcore/task_monitor.hpp"
+#include "robotcore/robot.hpp"
+#include "robotcore/topic.hpp"
+
+namespace block_tracker {
+
+// AI Vision image and field of view
+constexpr double IMAGE_WIDTH = 320.0;
+constexpr double IMAGE_HEIGHT = 240.0;
+constexpr double HFOV_DEG = 74.0;
+
+// Color descriptors for the blocks (id, r, g, b, hue range, saturation range)
+constexpr pros::AIVision::Color RED_BLOCK = {1, 200, 30, 40, 10.0f, 0.2f};
+constexpr pros::AIVision::Color BLUE_BLOCK = {2, 30, 70, 200, 10.0f, 0.2f};
+
+constexpr std::uint32_t MAX_DETECTIONS = 8;  // per frame, extras are ignored
+constexpr int MAX_TRACKS = 6;
+constexpr double MATCH_GATE_PX = 40.0;  // a block moves less than this between frames
+constexpr int CONFIRM_HITS = 3;         // frames seen before we steer at it
+constexpr int DROP_MISSES = 5;          // frames missed before we forget it
+constexpr std::uint32_t LOOP_MS = 20;   // sensor updates at 50 Hz
+
+struct Track {
+	bool active;
+	std::uint8_t id;
+	double x, y;  // bounding box center in pixels
+	double area;  // bounding box area in pixels
+	int hits;
+	int misses;
+};
+
+static pros::AIVision::Object detections[MAX_DETECTIONS];
+static bool detection_used[MAX_DETECTIONS];
+static Track tracks[MAX_TRACKS];
+static std::uint8_t next_id = 1;
+
+struct Published {
+	Target target;
+	bool valid;
+};
+
+static Topic<Published> target_topic;
+
+// Color descriptor id of the blocks we want, or 0 if no alliance is picked.
+static std::uint8_t wanted_color() {
+	switch (color_sort::alliance()) {
+		case color_sort::Alliance::red: return RED_BLOCK.id;
+		case color_sort::Alliance::blue: return BLUE_BLOCK.id;
+		default: return 0;
+	}
+}
+
+// Copies this frame's detections of our alliance's blocks into the fixed
+// buffer. The other alliance's blocks are never tracked, and nothing is
+// until an alliance is picked.
+static std::uint32_t poll() {
+	std::uint8_t wanted = wanted_color();
+	if (wanted == 0) return 0;
+	std::int32_t count = block_camera.get_object_count();
+	if (count == PROS_ERR || count < 0) return 0;
+	std::uint32_t n = 0;
+	for (std::int32_t i = 0; i < count && n < MAX_DETECTIONS; i++) {
+		pros::AIVision::Object object = block_camera.get_object(i);
+		if (pros::AIVision::is_type(object, pros::AivisionDetectType::color) && object.id == wanted) {
+			detections[n++] = object;
+		}
+	}
+	return n;
+}
+
+static void center_of(const pros::AIVision::Object& object, double& x, double& y, double& area) {
+	const pros::aivision_object_color_s_t& box = object.object.color;
+	x = box.xoffset + box.width / 2.0;
+	y = box.yoffset + box.height / 2.0;
+	area = static_cast<double>(box.width) * box.height;
+}
+
+// Greedy nearest-neighbour matching. With a handful of blocks in view this is
+// as good as anything fancier and costs a few dozen multiplies.
+static void associate(std::uint32_t n) {
+	for (std::uint32_t d = 0; d < n; d++) detection_used[d] = false;
+
+	for (Track& track : tracks) {
+		if (!track.active) continue;
+		int best = -1;
+		double best_dist2 = MATCH_GATE_PX * MATCH_GATE_PX;
+		for (std::uint32_t d = 0; d < n; d++) {
+			if (detection_used[d]) continue;
+			double x, y, area;
+			center_of(detections[d], x, y, area);
+			double dist2 = (x - track.x) * (x - track.x) + (y - track.y) * (y - track.y);
+			if (dist2 < best_dist2) {
+				best_dist2 = dist2;
+				best = d;
+			}
+		}
+		if (best >= 0) {
+			detection_used[best] = true;
+			center_of(detections[best], track.x, track.y, track.area);
+			track.hits++;
+			track.misses = 0;
+		} else if (++track.misses >= DROP_MISSES) {
+			track.active = false;
+		}
+	}
+
+	// Anything left over is a new block.
+	for (std::uint32_t d = 0; d < n; d++) {
+		if (detection_used[d]) continue;
+		for (Track& track : tracks) {
+			if (track.active) continue;
+			track = {true, next_id++, 0, 0, 0, 1, 0};
+			center_of(detections[d], track.x, track.y, track.area);
+			break;
+		}
+	}
+}
+
+// The closest confirmed block is the one with the biggest bounding box.
+static void publish() {
+	const Track* best = nullptr;
+	for (const Track& track : tracks) {
+		if (!track.active || track.hits < CONFIRM_HITS || track.misses > 0) continue;
+		if (best == nullptr || track.area > best->area) best = &track;
+	}
+
+	Published out = {};
+	out.valid = best != nullptr;
+	if (out.valid) {
+		out.target.track_id = best->id;
+		out.target.heading_deg = (best->x - IMAGE_WIDTH / 2.0) * HFOV_DEG / IMAGE_WIDTH;
+		out.target.size = best->area / (IMAGE_WIDTH * IMAGE_HEIGHT);
+	}
+	target_topic.publish(out);
+}
+
+static void track_task() {
+	int monitor_id = task_monitor::add("Block Tracker");
+	std::uint32_t now = pros::millis();
+	while (true) {
+		associate(poll());
+		publish();
+		task_monitor::delay_until(monitor_id, &now, LOOP_MS);
+	}
+}
+
+void start() {
+	block_camera.enable_detection_types(pros::AivisionModeType::colors);
+	block_camera.set_color(RED_BLOCK);  // both, the alliance can change after start(); poll() filters
+	block_camera.set_color(BLUE_BLOCK);
+	pros::Task task(track_task, "Block Tracker");
+}
+
+bool get_target(Target& out) {
+	Published published;
+	if (!target_topic.read(published) || !published.valid) return false;
+	out = published.target;
+	return true;
+}
+
+}  // namespace block_tracker
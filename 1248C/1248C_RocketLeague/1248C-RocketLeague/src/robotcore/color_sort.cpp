@@ -0,0 +1,127 @@
+#include "robotcore/color_sort.hpp"
+#include "robotcore/task_monitor.hpp"
+#include "robotcore/robot.hpp"
+#include <atomic>
+
+namespace color_sort {
+
+// Sensor tuning. Measure these on the robot if the conveyor changes.
+constexpr double RED_HUE_MAX = 30.0;         // red wraps around 0
+constexpr double RED_HUE_MIN = 330.0;
+constexpr double BLUE_HUE_MIN = 180.0;
+constexpr double BLUE_HUE_MAX = 260.0;
+constexpr std::int32_t BLOCK_PROXIMITY = 120;  // 0-255, higher is closer
+constexpr std::uint8_t LED_PWM = 100;          // constant light for stable hue
+constexpr double INTEGRATION_MS = 5.0;         // sensor update rate (min 3 ms)
+
+// Conveyor geometry
+constexpr double SENSOR_TO_ROLLER_MM = 90.0;  // block travel from sensor to top roller
+constexpr double MM_PER_CONVEYOR_REV = 100.0; // chain travel per conveyor motor rev
+constexpr double MIN_CONVEYOR_RPM = 10.0;     // slower than this and we don't sort
+
+constexpr std::uint32_t EJECT_MS = 150;  // how long the top roller reverses per block
+constexpr std::uint32_t LOOP_MS = 5;
+
+// Blocks seen but not yet at the top roller. Small fixed ring, the conveyor
+// only holds a few blocks between the sensor and the roller.
+constexpr int MAX_PENDING = 4;
+
+static std::atomic<Alliance> keep_color{Alliance::none};
+static std::atomic<bool> enabled{true};
+static std::atomic<bool> eject_active{false};
+static std::atomic<std::uint32_t> seen{0};
+static std::atomic<std::uint32_t> ejected{0};
+static std::atomic<std::uint32_t> worst_us{0};
+
+static std::uint32_t pending[MAX_PENDING];  // eject start times, millis()
+static int pending_head = 0;
+static int pending_count = 0;
+
+static Alliance classify(double hue) {
+	if (hue <= RED_HUE_MAX || hue >= RED_HUE_MIN) return Alliance::red;
+	if (hue >= BLUE_HUE_MIN && hue <= BLUE_HUE_MAX) return Alliance::blue;
+	return Alliance::none;
+}
+
+// Time in ms for a block to travel from the sensor to the top roller at the
+// current conveyor speed, or 0 if the conveyor is not feeding upward.
+static std::uint32_t travel_ms() {
+	double rpm = conveyor.get_actual_velocity();
+	if (rpm < MIN_CONVEYOR_RPM) return 0;
+	double mm_per_ms = rpm * MM_PER_CONVEYOR_REV / 60000.0;
+	return static_cast<std::uint32_t>(SENSOR_TO_ROLLER_MM / mm_per_ms);
+}
+
+static void sort_task() {
+	int monitor_id = task_monitor::add("Color Sort");
+	bool block_present = false;
+	std::int32_t saved_power = 0;
+	std::uint32_t eject_command = 0;  // top_roller_commands after our reverse
+	std::uint32_t eject_end = 0;
+	std::uint32_t now = pros::millis();
+
+	while (true) {
+		std::uint64_t start_us = pros::micros();
+		Alliance keep = keep_color.load();
+		bool sorting = enabled.load() && keep != Alliance::none;
+
+		// Rising edge of the proximity reading is a new block.
+		bool near = block_sensor.get_proximity() >= BLOCK_PROXIMITY;
+		if (near && !block_present) seen++;
+		if (near && !block_present && sorting) {
+			Alliance color = classify(block_sensor.get_hue());
+			std::uint32_t delay = travel_ms();
+			if (color != Alliance::none && color != keep && delay > 0 && pending_count < MAX_PENDING) {
+				pending[(pending_head + pending_count) % MAX_PENDING] = now + delay;
+				pending_count++;
+			}
+			std::uint32_t took = static_cast<std::uint32_t>(pros::micros() - start_us);
+			if (took > worst_us.load()) worst_us = took;
+		}
+		block_present = near;
+
+		// Start the next eject once its block reaches the top roller.
+		if (!eject_active && pending_count > 0 && static_cast<std::int32_t>(now - pending[pending_head]) >= 0) {
+			pending_head = (pending_head + 1) % MAX_PENDING;
+			pending_count--;
+			saved_power = top_roller_power;
+			eject_active = true;
+			eject_end = now + EJECT_MS;
+			top_roller_reverse();
+			eject_command = top_roller_commands;
+		}
+
+		// Give the top roller back at whatever it was doing before, unless
+		// something (autonomous, opcontrol) has commanded it since.
+		if (eject_active && static_cast<std::int32_t>(now - eject_end) >= 0) {
+			if (top_roller_commands == eject_command) move_top_roller(saved_power);
+			eject_active = false;
+			ejected++;
+		}
+
+		task_monitor::delay_until(monitor_id, &now, LOOP_MS);
+	}
+}
+
+void start(Alliance keep) {
+	keep_color = keep;
+	block_sensor.set_led_pwm(LED_PWM);
+	block_sensor.set_integration_time(INTEGRATION_MS);
+	pros::Task task(sort_task, TASK_PRIORITY_MAX - 1, TASK_STACK_DEPTH_DEFAULT, "Color Sort");
+}
+
+void set_alliance(Alliance keep) { keep_color = keep; }
+
+Alliance alliance() { return keep_color; }
+
+void set_enabled(bool on) { enabled = on; }
+
+bool ejecting() { return eject_active; }
+
+std::uint32_t blocks_seen() { return seen; }
+
+std::uint32_t ejected_count() { return ejected; }
+
+std::uint32_t worst_decision_us() { return worst_us; }
+
+}  // namespace color_sort
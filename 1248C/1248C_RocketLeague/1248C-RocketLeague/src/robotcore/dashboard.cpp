@@ -0,0 +1,145 @@
+#include "robotcore/dashboard.hpp"
+#include "robotcore/color_sort.hpp"
+#include "robotcore/glyph_cache.hpp"
+#include "robotcore/robot.hpp"
+#include "robotcore/screen_budget.hpp"
+#include "robotcore/spsc_queue.hpp"
+#include "robotcore/stream_chart.hpp"
+#include "liblvgl/lvgl.h"
+
+namespace dashboard {
+
+constexpr std::uint32_t DRAW_PERIOD_MS = 100;
+constexpr std::uint32_t DRAW_BUDGET_US = 2000;  // most time one timer run may spend on widgets
+constexpr int SAMPLES_PER_COLUMN = 2;           // 20 ms ticks, so about 12 s across a chart
+constexpr int MAX_TEMP_C = 70;                  // V5 motors start limiting at 55 C
+
+static SpscQueue<Sample, 32> samples;
+
+static lv_obj_t* screen = nullptr;
+static lv_obj_t* previous_screen = nullptr;
+static lv_obj_t* current_chart;
+static lv_obj_t* jitter_chart;
+static lv_obj_t* temp_bars[DRIVE_MOTORS + 2];
+static lv_obj_t* throughput_label;
+static lv_obj_t* jitter_label;
+
+static std::uint16_t blocks_at_last_draw = 0;
+static std::uint32_t last_draw_ms = 0;
+static std::uint32_t overruns = 0;
+
+static lv_obj_t* make_chart(std::int32_t y, std::int32_t max) {
+	lv_obj_t* chart = stream_chart::create(screen, 300, 110, 0, max, SAMPLES_PER_COLUMN);
+	lv_obj_set_pos(chart, 5, y);
+	screen_budget::set_priority(chart, screen_budget::Priority::low);  // a frame late is fine
+	return chart;
+}
+
+// Runs on the LVGL task, so it is the only code touching the widgets.
+static void draw(lv_timer_t*) {
+	if (lv_screen_active() != screen) {
+		// Nobody is looking, just keep the queue from filling up.
+		Sample discard;
+		while (samples.pop(discard)) {}
+		return;
+	}
+
+	std::uint64_t start = pros::micros();
+	Sample sample;
+	Sample latest;
+	bool any = false;
+	std::int32_t worst_jitter = 0;
+	while (samples.pop(sample)) {
+		std::int32_t left = 0, right = 0;
+		for (int i = 0; i < DRIVE_MOTORS / 2; i++) left += sample.drive_current_ma[i];
+		for (int i = DRIVE_MOTORS / 2; i < DRIVE_MOTORS; i++) right += sample.drive_current_ma[i];
+		stream_chart::push(current_chart, {left, right});
+		stream_chart::push(jitter_chart, {sample.loop_jitter_us});
+		if (sample.loop_jitter_us > worst_jitter) worst_jitter = sample.loop_jitter_us;
+		latest = sample;
+		any = true;
+		if (pros::micros() - start > DRAW_BUDGET_US) {
+			overruns++;
+			break;  // leave the rest for next time
+		}
+	}
+	stream_chart::flush(current_chart);
+	stream_chart::flush(jitter_chart);
+	if (!any) return;
+
+	for (int i = 0; i < DRIVE_MOTORS; i++) lv_bar_set_value(temp_bars[i], latest.drive_temp_c[i], LV_ANIM_OFF);
+	lv_bar_set_value(temp_bars[DRIVE_MOTORS], latest.conveyor_temp_c, LV_ANIM_OFF);
+	lv_bar_set_value(temp_bars[DRIVE_MOTORS + 1], latest.top_roller_temp_c, LV_ANIM_OFF);
+
+	std::uint32_t now = pros::millis();
+	std::uint32_t elapsed = now - last_draw_ms;
+	std::uint16_t blocks = latest.blocks_seen - blocks_at_last_draw;
+	if (elapsed > 0) {
+		lv_label_set_text_fmt(throughput_label, "Blocks/s: %d", static_cast<int>(blocks * 1000 / elapsed));
+	}
+	lv_label_set_text_fmt(jitter_label, "Jitter: %d us  Over: %d", static_cast<int>(worst_jitter),
+	                      static_cast<int>(overruns));
+	blocks_at_last_draw = latest.blocks_seen;
+	last_draw_ms = now;
+}
+
+static void on_tap(lv_event_t*) { show(false); }
+
+void start() {
+	screen = lv_obj_create(nullptr);
+	lv_obj_add_event_cb(screen, on_tap, LV_EVENT_CLICKED, nullptr);
+
+	// Drive current, left and right side totals
+	current_chart = make_chart(5, 2500 * DRIVE_MOTORS / 2);
+	stream_chart::add_series(current_chart, lv_palette_main(LV_PALETTE_RED));
+	stream_chart::add_series(current_chart, lv_palette_main(LV_PALETTE_BLUE));
+
+	// How late each control loop tick started
+	jitter_chart = make_chart(120, 5000);
+	stream_chart::add_series(jitter_chart, lv_palette_main(LV_PALETTE_GREEN));
+
+	// Motor temperatures: six drive motors, then conveyor and top roller
+	for (int i = 0; i < DRIVE_MOTORS + 2; i++) {
+		temp_bars[i] = lv_bar_create(screen);
+		lv_obj_set_pos(temp_bars[i], 315 + i * 20, 5);
+		lv_obj_set_size(temp_bars[i], 14, 150);
+		lv_bar_set_range(temp_bars[i], 0, MAX_TEMP_C);
+	}
+
+	throughput_label = lv_label_create(screen);
+	lv_obj_set_pos(throughput_label, 315, 165);
+	lv_label_set_text(throughput_label, "Blocks/s: -");
+
+	jitter_label = lv_label_create(screen);
+	lv_obj_set_pos(jitter_label, 315, 190);
+	lv_label_set_text(jitter_label, "Jitter: -");
+
+	glyph_cache::attach(screen);
+	lv_timer_create(draw, DRAW_PERIOD_MS, nullptr);
+	pros::lcd::register_btn2_cb([] { show(true); });
+}
+
+void push(const Sample& sample) { samples.push(sample); }
+
+void read_robot(Sample& sample) {
+	for (int i = 0; i < DRIVE_MOTORS / 2; i++) {
+		sample.drive_current_ma[i] = left_mg.get_current_draw(i);
+		sample.drive_current_ma[DRIVE_MOTORS / 2 + i] = right_mg.get_current_draw(i);
+		sample.drive_temp_c[i] = left_mg.get_temperature(i);
+		sample.drive_temp_c[DRIVE_MOTORS / 2 + i] = right_mg.get_temperature(i);
+	}
+	sample.conveyor_temp_c = conveyor.get_temperature();
+	sample.top_roller_temp_c = top_roller.get_temperature();
+	sample.blocks_seen = color_sort::blocks_seen();
+}
+
+void show(bool visible) {
+	if (visible && lv_screen_active() != screen) {
+		previous_screen = lv_screen_active();
+		lv_screen_load(screen);
+	} else if (!visible && previous_screen != nullptr) {
+		lv_screen_load(previous_screen);
+	}
+}
+
+}  // namespace dashboard
@@ -0,0 +1,247 @@
+#include "robotcore/ghost.hpp"
+#include "robotcore/task_monitor.hpp"
+#include "robotcore/robot.hpp"
+#include "robotcore/spsc_queue.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace ghost {
+
+constexpr std::uint32_t WRITER_LOOP_MS = 20;
+constexpr std::size_t CHUNK = 512;  // bytes per SD card read or write
+constexpr char MAGIC[4] = {'G', 'H', 'S', 'T'};
+constexpr std::uint8_t VERSION = 1;
+
+// Playback: motor units of correction per degree the drive is behind the recording
+constexpr double POSITION_GAIN = 0.3;
+
+// Frame fields in the order they are encoded
+enum Field { LEFT, RIGHT, CONVEYOR, TOP_ROLLER, LEFT_DEG, RIGHT_DEG, SOLENOIDS, FIELDS };
+constexpr std::size_t MAX_RECORD = 1 + 5 + FIELDS * 5;  // mask, time and every field as a 5 byte varint
+
+enum State { IDLE, RECORDING, CLOSING };
+
+static std::atomic<int> state{IDLE};
+static std::atomic<std::uint32_t> dropped_frames{0};
+static SpscQueue<Frame, 64> queue;  // a bit over a second of frames
+
+// Owned by the writer task while recording, and by begin_recording() while idle
+static FILE* file = nullptr;
+static std::uint32_t start_ms = 0;
+static std::uint8_t chunk[CHUNK];
+static std::size_t used = 0;
+static std::int32_t last[FIELDS];
+static std::uint32_t last_time = 0;
+
+// A failed position read keeps the last good one.
+static std::int32_t degrees(double reading, std::int32_t previous) {
+	return std::isfinite(reading) ? static_cast<std::int32_t>(std::lround(reading)) : previous;
+}
+
+static void unpack(const Frame& frame, std::int32_t* values) {
+	values[LEFT] = frame.left;
+	values[RIGHT] = frame.right;
+	values[CONVEYOR] = frame.conveyor;
+	values[TOP_ROLLER] = frame.top_roller;
+	values[LEFT_DEG] = degrees(frame.left_deg, last[LEFT_DEG]);
+	values[RIGHT_DEG] = degrees(frame.right_deg, last[RIGHT_DEG]);
+	values[SOLENOIDS] = frame.solenoids;
+}
+
+static std::uint32_t zigzag(std::int32_t n) {
+	return (static_cast<std::uint32_t>(n) << 1) ^ static_cast<std::uint32_t>(n >> 31);
+}
+
+static std::int32_t unzigzag(std::uint32_t n) {
+	return static_cast<std::int32_t>(n >> 1) ^ -static_cast<std::int32_t>(n & 1);
+}
+
+static void put_varint(std::uint32_t n) {
+	while (n >= 0x80) {
+		chunk[used++] = static_cast<std::uint8_t>(n | 0x80);
+		n >>= 7;
+	}
+	chunk[used++] = static_cast<std::uint8_t>(n);
+}
+
+static void flush() {
+	if (used > 0) std::fwrite(chunk, 1, used, file);
+	used = 0;
+}
+
+static void encode(const Frame& frame) {
+	std::int32_t values[FIELDS];
+	unpack(frame, values);
+
+	if (CHUNK - used < MAX_RECORD) flush();
+	std::uint8_t mask = 0;
+	for (int i = 0; i < FIELDS; i++) {
+		if (values[i] != last[i]) mask |= 1 << i;
+	}
+	chunk[used++] = mask;
+	put_varint(frame.time_ms - last_time);
+	for (int i = 0; i < FIELDS; i++) {
+		if (!(mask & (1 << i))) continue;
+		if (i == SOLENOIDS) chunk[used++] = static_cast<std::uint8_t>(values[i]);
+		else put_varint(zigzag(values[i] - last[i]));
+		last[i] = values[i];
+	}
+	last_time = frame.time_ms;
+}
+
+static void writer_task() {
+	int monitor_id = task_monitor::add("Ghost Writer");
+	std::uint32_t now = pros::millis();
+	while (true) {
+		if (state.load() != IDLE) {
+			Frame frame;
+			while (queue.pop(frame)) encode(frame);
+			if (state.load() == CLOSING) {
+				flush();
+				std::fclose(file);
+				file = nullptr;
+				state.store(IDLE);
+			}
+		}
+		task_monitor::delay_until(monitor_id, &now, WRITER_LOOP_MS);
+	}
+}
+
+void start() { pros::Task task(writer_task, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "Ghost Writer"); }
+
+bool begin_recording(const char* path) {
+	if (state.load() != IDLE || !pros::usd::is_installed()) return false;
+	file = std::fopen(path, "wb");
+	if (file == nullptr) return false;
+	std::setvbuf(file, nullptr, _IONBF, 0);  // chunk is the buffer, so stdio doesn't malloc one
+	std::memcpy(chunk, MAGIC, sizeof(MAGIC));
+	chunk[sizeof(MAGIC)] = VERSION;
+	used = sizeof(MAGIC) + 1;
+	std::fill(last, last + FIELDS, 0);
+	last_time = 0;
+	dropped_frames = 0;
+
+	left_mg.tare_position_all();
+	right_mg.tare_position_all();
+	start_ms = pros::millis();
+	state.store(RECORDING);
+	return true;
+}
+
+void record(const Frame& frame) {
+	if (state.load() != RECORDING) return;
+	Frame relative = frame;
+	relative.time_ms -= start_ms;
+	if (!queue.push(relative)) dropped_frames++;
+}
+
+void end_recording() {
+	int expected = RECORDING;
+	state.compare_exchange_strong(expected, CLOSING);
+}
+
+bool recording() { return state.load() == RECORDING; }
+
+std::uint32_t dropped() { return dropped_frames; }
+
+// Streams a recording off the card one chunk at a time.
+class Reader {
+	public:
+	explicit Reader(FILE* in) : in(in) {}
+
+	bool byte(std::uint8_t& out) {
+		if (next == size) {
+			size = std::fread(buffer, 1, CHUNK, in);
+			next = 0;
+			if (size == 0) return false;
+		}
+		out = buffer[next++];
+		return true;
+	}
+
+	bool varint(std::uint32_t& out) {
+		out = 0;
+		for (int shift = 0; shift < 35; shift += 7) {
+			std::uint8_t b;
+			if (!byte(b)) return false;
+			out |= static_cast<std::uint32_t>(b & 0x7F) << shift;
+			if (!(b & 0x80)) return true;
+		}
+		return false;  // too long, not a varint
+	}
+
+	// Applies the next record to values and returns the ms since the last one.
+	bool frame(std::int32_t* values, std::uint32_t& dt) {
+		std::uint8_t mask;
+		if (!byte(mask) || !varint(dt)) return false;
+		for (int i = 0; i < FIELDS; i++) {
+			if (!(mask & (1 << i))) continue;
+			if (i == SOLENOIDS) {
+				std::uint8_t bits;
+				if (!byte(bits)) return false;
+				values[i] = bits;
+			} else {
+				std::uint32_t delta;
+				if (!varint(delta)) return false;
+				values[i] += unzigzag(delta);
+			}
+		}
+		return true;
+	}
+
+	private:
+	FILE* in;
+	std::uint8_t buffer[CHUNK];
+	std::size_t size = 0;
+	std::size_t next = 0;
+};
+
+static std::int32_t track(std::int32_t command, std::int32_t recorded_deg, double actual_deg) {
+	if (!std::isfinite(actual_deg)) return command;  // no reading, run open loop
+	double corrected = command + POSITION_GAIN * (recorded_deg - actual_deg);
+	return std::clamp(static_cast<std::int32_t>(corrected), -127, 127);
+}
+
+bool play(const char* path) {
+	if (!pros::usd::is_installed()) return false;
+	FILE* in = std::fopen(path, "rb");
+	if (in == nullptr) return false;
+	std::setvbuf(in, nullptr, _IONBF, 0);  // Reader does the buffering
+	Reader reader(in);
+	std::uint8_t header[sizeof(MAGIC) + 1];
+	for (std::uint8_t& b : header) {
+		if (!reader.byte(b)) b = 0;
+	}
+	if (std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0 || header[sizeof(MAGIC)] != VERSION) {
+		std::fclose(in);
+		return false;
+	}
+
+	std::int32_t values[FIELDS] = {};
+	std::uint32_t dt;
+	left_mg.tare_position_all();
+	right_mg.tare_position_all();
+	std::uint32_t now = pros::millis();
+
+	while (reader.frame(values, dt)) {
+		pros::Task::delay_until(&now, dt);
+		left_mg.move(track(values[LEFT], values[LEFT_DEG], left_mg.get_position()));
+		right_mg.move(track(values[RIGHT], values[RIGHT_DEG], right_mg.get_position()));
+		conveyor.move(values[CONVEYOR]);
+		move_top_roller(values[TOP_ROLLER]);
+		descorer.set_value(values[SOLENOIDS] & DESCORER_BIT);
+		match_loader_solenoid.set_value(values[SOLENOIDS] & MATCH_LOADER_BIT);
+	}
+	std::fclose(in);
+
+	left_mg.move(0);
+	right_mg.move(0);
+	conveyor_off();
+	top_roller_off();
+	return true;
+}
+
+}  // namespace ghost
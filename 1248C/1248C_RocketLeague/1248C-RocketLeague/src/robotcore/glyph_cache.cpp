@@ -0,0 +1,135 @@
+#include "robotcore/glyph_cache.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace glyph_cache {
+
+constexpr std::uint16_t NO_SLOT = 0xFFFF;
+
+// One cache node. font and index are the key.
+struct Glyph {
+	const lv_font_t* font;
+	std::uint32_t index;
+	std::uint16_t slot;
+	std::uint16_t stride;
+	std::uint16_t height;
+};
+
+// Handed to create() so it can decode a glyph that isn't cached yet.
+struct Decode {
+	lv_font_glyph_dsc_t* dsc;
+	std::uint32_t stride;
+	bool created;
+};
+
+alignas(8) static std::uint8_t atlas[SLOTS][SLOT_BYTES];
+static std::uint16_t free_slots[SLOTS];
+static int free_count = 0;
+static lv_cache_t* cache = nullptr;
+
+// Our copies of the fonts, and the fonts they were copied from.
+static lv_font_t fonts[MAX_FONTS];
+static const lv_font_t* originals[MAX_FONTS];
+static int font_count = 0;
+
+static Stats totals = {};
+
+static const lv_font_t* original(const lv_font_t* font) { return originals[font - fonts]; }
+
+static lv_cache_compare_res_t compare(const void* a, const void* b) {
+	const Glyph* first = static_cast<const Glyph*>(a);
+	const Glyph* second = static_cast<const Glyph*>(b);
+	if (first->font != second->font) return first->font < second->font ? -1 : 1;
+	if (first->index != second->index) return first->index < second->index ? -1 : 1;
+	return 0;
+}
+
+// Decodes straight into a free slot.
+static bool create(void* node, void* user_data) {
+	Glyph* glyph = static_cast<Glyph*>(node);
+	Decode* decode = static_cast<Decode*>(user_data);
+	if (free_count == 0) return false;
+	std::uint16_t slot = free_slots[free_count - 1];
+	lv_draw_buf_t slot_buf;
+	lv_draw_buf_init(&slot_buf, decode->dsc->box_w, decode->dsc->box_h, LV_COLOR_FORMAT_A8, decode->stride,
+	                 atlas[slot], SLOT_BYTES);
+	if (original(glyph->font)->get_glyph_bitmap(decode->dsc, &slot_buf) != &slot_buf) return false;
+	free_count--;
+	glyph->slot = slot;
+	glyph->stride = static_cast<std::uint16_t>(decode->stride);
+	glyph->height = decode->dsc->box_h;
+	decode->created = true;
+	return true;
+}
+
+static void release_slot(void* node, void*) {
+	Glyph* glyph = static_cast<Glyph*>(node);
+	if (glyph->slot != NO_SLOT) free_slots[free_count++] = glyph->slot;
+}
+
+// get_glyph_bitmap for our font copies. Runs on the LVGL task.
+static const void* get_bitmap(lv_font_glyph_dsc_t* dsc, lv_draw_buf_t* draw_buf) {
+	const lv_font_t* font = dsc->resolved_font;
+	std::uint32_t stride = draw_buf != nullptr ? draw_buf->header.stride : 0;
+	if (stride == 0 || stride * dsc->box_h > SLOT_BYTES) {
+		totals.uncached++;
+		return original(font)->get_glyph_bitmap(dsc, draw_buf);
+	}
+
+	Glyph key = {font, dsc->gid.index, NO_SLOT, 0, 0};
+	Decode decode = {dsc, stride, false};
+	lv_cache_entry_t* entry = lv_cache_acquire_or_create(cache, &key, &decode);
+	if (entry == nullptr) {
+		totals.uncached++;
+		return original(font)->get_glyph_bitmap(dsc, draw_buf);
+	}
+	if (decode.created) {
+		totals.misses++;
+	} else {
+		totals.hits++;
+	}
+
+	const Glyph* glyph = static_cast<const Glyph*>(lv_cache_entry_get_data(entry));
+	std::uint32_t row = std::min<std::uint32_t>(glyph->stride, stride);
+	for (std::uint32_t y = 0; y < glyph->height; y++) {
+		std::memcpy(draw_buf->data + y * stride, atlas[glyph->slot] + y * glyph->stride, row);
+	}
+	lv_cache_release(cache, entry, nullptr);
+	return draw_buf;
+}
+
+static const lv_font_t* wrap(const lv_font_t* font) {
+	if (font == nullptr || font->get_glyph_bitmap == get_bitmap || font->get_glyph_bitmap == nullptr) return font;
+	for (int i = 0; i < font_count; i++) {
+		if (originals[i] == font) return &fonts[i];
+	}
+	if (font_count == MAX_FONTS) return font;
+	fonts[font_count] = *font;
+	fonts[font_count].get_glyph_bitmap = get_bitmap;
+	originals[font_count] = font;
+	return &fonts[font_count++];
+}
+
+static lv_obj_tree_walk_res_t attach_label(lv_obj_t* obj, void*) {
+	if (lv_obj_check_type(obj, &lv_label_class)) {
+		const lv_font_t* font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
+		const lv_font_t* cached = wrap(font);
+		if (cached != font) lv_obj_set_style_text_font(obj, cached, 0);
+	}
+	return LV_OBJ_TREE_WALK_NEXT;
+}
+
+void attach(lv_obj_t* root) {
+	if (cache == nullptr) {
+		for (int i = 0; i < SLOTS; i++) free_slots[i] = static_cast<std::uint16_t>(i);
+		free_count = SLOTS;
+		cache = lv_cache_create(&lv_cache_class_lru_rb_count, sizeof(Glyph), SLOTS, {compare, create, release_slot});
+		if (cache == nullptr) return;
+		lv_cache_set_name(cache, "glyph_atlas");
+	}
+	lv_obj_tree_walk(root, attach_label, nullptr);
+}
+
+Stats stats() { return totals; }
+
+}  // namespace glyph_cache
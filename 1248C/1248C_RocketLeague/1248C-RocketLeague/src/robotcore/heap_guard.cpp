@@ -0,0 +1,67 @@
+#include "robotcore/heap_guard.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <unistd.h>
+
+namespace heap_guard {
+
+static std::atomic<bool> is_sealed{false};
+static std::atomic<std::uint32_t> allocations{0};
+static std::atomic<std::uint32_t> bytes{0};
+
+void seal() {
+	// newlib hands out FILE structs from blocks it mallocs the first time it
+	// runs out, and keeps them for reuse after fclose(). fopen() claims one
+	// even when the open itself fails, so this makes sure the block exists.
+	// It runs in every build, not just HEAP_GUARD=1 ones: the guard only
+	// traps C++ allocations and never sees this C malloc. What it is for is
+	// keeping that block out of the heap after initialize(), where the first
+	// SD card fopen() (ghost, tune) would otherwise leave it in the
+	// middle of whatever was freed around it.
+	FILE* file = std::fopen("/usd/.heap_guard", "r");
+	if (file != nullptr) std::fclose(file);
+	is_sealed = true;
+}
+
+bool sealed() { return is_sealed; }
+
+std::uint32_t startup_allocations() { return allocations; }
+
+std::uint32_t startup_bytes() { return bytes; }
+
+#ifdef ROBOTCORE_HEAP_GUARD
+[[gnu::noinline]] static void* allocate(std::size_t size, void* caller) {
+	if (is_sealed) {
+		// snprintf and write() don't allocate, printf might.
+		char text[80];
+		int len = std::snprintf(text, sizeof(text), "heap_guard: %u byte allocation after initialize() from %p\n",
+		                        static_cast<unsigned>(size), caller);
+		if (len > 0) write(STDERR_FILENO, text, static_cast<std::size_t>(len));
+		__builtin_trap();
+	}
+	allocations++;
+	bytes += size;
+	void* memory = std::malloc(size == 0 ? 1 : size);
+	if (memory == nullptr) std::abort();
+	return memory;
+}
+#endif
+
+}  // namespace heap_guard
+
+#ifdef ROBOTCORE_HEAP_GUARD
+void* operator new(std::size_t size) { return heap_guard::allocate(size, __builtin_return_address(0)); }
+void* operator new[](std::size_t size) { return heap_guard::allocate(size, __builtin_return_address(0)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	return heap_guard::allocate(size, __builtin_return_address(0));
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	return heap_guard::allocate(size, __builtin_return_address(0));
+}
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+#endif
@@ -0,0 +1,247 @@
+#include "robotcore/image_assets.hpp"
+#include <cstring>
+
+namespace image_assets {
+
+static Stats totals = {};
+
+// LVGL's RLE (lv_rle.c): a control byte, then with the top bit set that many
+// pixels copied as is, otherwise one pixel repeated that many times.
+static bool rle_decompress(const std::uint8_t* in, std::uint32_t in_size, std::uint8_t* out, std::uint32_t out_size,
+                           std::uint32_t pixel_size) {
+	const std::uint8_t* in_end = in + in_size;
+	std::uint8_t* out_end = out + out_size;
+	while (in < in_end) {
+		std::uint32_t control = *in++;
+		std::uint32_t count = control & 0x7F;
+		std::uint32_t bytes = count * pixel_size;
+		if (bytes > static_cast<std::uint32_t>(out_end - out)) return false;
+		if (control & 0x80) {
+			if (bytes > static_cast<std::uint32_t>(in_end - in)) return false;
+			std::memcpy(out, in, bytes);
+			in += bytes;
+			out += bytes;
+		} else {
+			if (pixel_size > static_cast<std::uint32_t>(in_end - in)) return false;
+			for (std::uint32_t i = 0; i < count; i++, out += pixel_size) std::memcpy(out, in, pixel_size);
+			in += pixel_size;
+		}
+	}
+	return out == out_end;
+}
+
+// Reads an LZ4 length: 15 in the token means more bytes follow, each added
+// on until one isn't 255.
+static bool lz4_length(const std::uint8_t*& in, const std::uint8_t* in_end, std::uint32_t& length) {
+	if (length != 15) return true;
+	std::uint8_t more;
+	do {
+		if (in == in_end) return false;
+		more = *in++;
+		length += more;
+	} while (more == 255);
+	return true;
+}
+
+// One LZ4 block (lz4_Block_format.md): sequences of literals copied as is,
+// then a match copied from earlier output.
+static bool lz4_decompress(const std::uint8_t* in, std::uint32_t in_size, std::uint8_t* out, std::uint32_t out_size) {
+	const std::uint8_t* in_end = in + in_size;
+	std::uint8_t* out_start = out;
+	std::uint8_t* out_end = out + out_size;
+	while (in < in_end) {
+		std::uint32_t token = *in++;
+		std::uint32_t literals = token >> 4;
+		if (!lz4_length(in, in_end, literals)) return false;
+		if (literals > static_cast<std::uint32_t>(in_end - in) || literals > static_cast<std::uint32_t>(out_end - out)) {
+			return false;
+		}
+		std::memcpy(out, in, literals);
+		in += literals;
+		out += literals;
+		if (in == in_end) break;  // the last sequence has no match
+
+		if (in_end - in < 2) return false;
+		std::uint32_t offset = in[0] | in[1] << 8;
+		in += 2;
+		std::uint32_t length = token & 0x0F;
+		if (!lz4_length(in, in_end, length)) return false;
+		length += 4;
+		if (offset == 0 || offset > static_cast<std::uint32_t>(out - out_start) ||
+		    length > static_cast<std::uint32_t>(out_end - out)) {
+			return false;
+		}
+		const std::uint8_t* from = out - offset;
+		if (offset >= length) {
+			std::memcpy(out, from, length);
+			out += length;
+		} else {
+			// Overlaps what it is writing, which repeats the last offset bytes.
+			for (std::uint32_t i = 0; i < length; i++) *out++ = *from++;
+		}
+	}
+	return out == out_end;
+}
+
+bool decompress(lv_image_compress_t method, const std::uint8_t* in, std::uint32_t in_size, std::uint8_t* out,
+                std::uint32_t out_size, std::uint32_t pixel_size) {
+	switch (method) {
+		case LV_IMAGE_COMPRESS_NONE:
+			if (in_size != out_size) return false;
+			std::memcpy(out, in, out_size);
+			return true;
+		case LV_IMAGE_COMPRESS_RLE: return rle_decompress(in, in_size, out, out_size, pixel_size);
+		case LV_IMAGE_COMPRESS_LZ4: return lz4_decompress(in, in_size, out, out_size);
+	}
+	return false;
+}
+
+// Formats we draw straight from the decoded pixels; LVGL's decoder keeps the rest.
+static bool supported(lv_color_format_t format) {
+	switch (format) {
+		case LV_COLOR_FORMAT_ARGB8888:
+		case LV_COLOR_FORMAT_XRGB8888:
+		case LV_COLOR_FORMAT_RGB888:
+		case LV_COLOR_FORMAT_RGB565:
+		case LV_COLOR_FORMAT_A8:
+		case LV_COLOR_FORMAT_L8: return true;
+		default: return false;
+	}
+}
+
+static bool read_header(lv_fs_file_t* file, lv_image_header_t& header) {
+	std::uint32_t read = 0;
+	if (lv_fs_read(file, &header, sizeof(header), &read) != LV_FS_RES_OK || read != sizeof(header)) return false;
+	return header.magic == LV_IMAGE_HEADER_MAGIC && supported(static_cast<lv_color_format_t>(header.cf)) &&
+	       header.stride >= lv_color_format_get_size(static_cast<lv_color_format_t>(header.cf)) * header.w;
+}
+
+static bool is_asset(const lv_image_decoder_dsc_t* dsc) {
+	if (dsc->src_type != LV_IMAGE_SRC_FILE) return false;
+	return std::strcmp(lv_fs_get_ext(static_cast<const char*>(dsc->src)), "bin") == 0;
+}
+
+static lv_result_t image_info(lv_image_decoder_t*, lv_image_decoder_dsc_t* dsc, lv_image_header_t* header) {
+	if (!is_asset(dsc)) return LV_RESULT_INVALID;
+	lv_fs_file_t file;
+	if (lv_fs_open(&file, static_cast<const char*>(dsc->src), LV_FS_MODE_RD) != LV_FS_RES_OK) return LV_RESULT_INVALID;
+	bool ok = read_header(&file, *header);
+	lv_fs_close(&file);
+	if (!ok) return LV_RESULT_INVALID;
+	header->flags &= ~LV_IMAGE_FLAGS_COMPRESSED;  // what we hand LVGL isn't
+	return LV_RESULT_OK;
+}
+
+// Reads the pixels after the header into decoded, in one read.
+static bool read_pixels(lv_fs_file_t* file, const lv_image_header_t& header, lv_draw_buf_t* decoded) {
+	std::uint32_t size = header.stride * header.h;
+	std::uint32_t read = 0;
+	if (!(header.flags & LV_IMAGE_FLAGS_COMPRESSED)) {
+		return lv_fs_read(file, decoded->data, size, &read) == LV_FS_RES_OK && read == size;
+	}
+	CompressedHeader compressed;
+	if (lv_fs_read(file, &compressed, sizeof(compressed), &read) != LV_FS_RES_OK || read != sizeof(compressed) ||
+	    compressed.decompressed_size != size) {
+		return false;
+	}
+	std::uint8_t* packed = static_cast<std::uint8_t*>(lv_malloc(compressed.compressed_size));
+	if (packed == nullptr) return false;
+	bool ok = lv_fs_read(file, packed, compressed.compressed_size, &read) == LV_FS_RES_OK &&
+	          read == compressed.compressed_size &&
+	          decompress(static_cast<lv_image_compress_t>(compressed.method), packed, compressed.compressed_size,
+	                     decoded->data, size, lv_color_format_get_size(static_cast<lv_color_format_t>(header.cf)));
+	lv_free(packed);
+	return ok;
+}
+
+static lv_result_t open_image(lv_image_decoder_t* decoder, lv_image_decoder_dsc_t* dsc) {
+	std::uint32_t start = lv_tick_get();
+	lv_fs_file_t file;
+	if (lv_fs_open(&file, static_cast<const char*>(dsc->src), LV_FS_MODE_RD) != LV_FS_RES_OK) {
+		totals.failed++;
+		return LV_RESULT_INVALID;
+	}
+	lv_image_header_t header;
+	lv_draw_buf_t* decoded = nullptr;
+	if (read_header(&file, header)) {
+		decoded = lv_draw_buf_create(header.w, header.h, static_cast<lv_color_format_t>(header.cf), header.stride);
+	}
+	if (decoded != nullptr && !read_pixels(&file, header, decoded)) {
+		lv_draw_buf_destroy(decoded);
+		decoded = nullptr;
+	}
+	lv_fs_close(&file);
+	if (decoded == nullptr) {
+		totals.failed++;
+		return LV_RESULT_INVALID;
+	}
+
+	// Stride alignment or premultiplying, if the renderer asked for them.
+	lv_draw_buf_t* adjusted = lv_image_decoder_post_process(dsc, decoded);
+	if (adjusted == nullptr) {
+		lv_draw_buf_destroy(decoded);
+		return LV_RESULT_INVALID;
+	}
+	if (adjusted != decoded) lv_draw_buf_destroy(decoded);
+	dsc->decoded = adjusted;
+	totals.decoded++;
+	totals.last_decode_ms = lv_tick_elaps(start);
+
+	if (dsc->args.no_cache || !lv_image_cache_is_enabled()) return LV_RESULT_OK;
+	lv_image_cache_data_t key = {};
+	key.src_type = dsc->src_type;
+	key.src = dsc->src;
+	key.slot.size = adjusted->data_size;
+	lv_cache_entry_t* entry = lv_image_decoder_add_to_cache(decoder, &key, adjusted, nullptr);
+	if (entry == nullptr) {
+		lv_draw_buf_destroy(adjusted);
+		return LV_RESULT_INVALID;
+	}
+	dsc->cache_entry = entry;
+	return LV_RESULT_OK;
+}
+
+static void close_image(lv_image_decoder_t*, lv_image_decoder_dsc_t* dsc) {
+	// Cached buffers belong to the cache from here.
+	if (dsc->args.no_cache || !lv_image_cache_is_enabled()) {
+		lv_draw_buf_destroy(const_cast<lv_draw_buf_t*>(dsc->decoded));
+	}
+}
+
+static lv_obj_tree_walk_res_t drop_image(lv_obj_t* obj, void*) {
+	if (lv_obj_check_type(obj, &lv_image_class)) {
+		const void* src = lv_image_get_src(obj);
+		if (src != nullptr && lv_image_src_get_type(src) == LV_IMAGE_SRC_FILE) lv_image_cache_drop(src);
+	}
+	return LV_OBJ_TREE_WALK_NEXT;
+}
+
+static void on_unloaded(lv_event_t* event) {
+	lv_obj_tree_walk(static_cast<lv_obj_t*>(lv_event_get_target(event)), drop_image, nullptr);
+}
+
+void start(std::uint32_t cache_bytes) {
+	static lv_image_decoder_t* decoder = nullptr;
+	if (decoder == nullptr) {
+		decoder = lv_image_decoder_create();  // tried before the built-in decoders
+		if (decoder == nullptr) return;
+		lv_image_decoder_set_info_cb(decoder, image_info);
+		lv_image_decoder_set_open_cb(decoder, open_image);
+		lv_image_decoder_set_close_cb(decoder, close_image);
+		decoder->name = "robotcore_assets";
+	}
+	lv_image_cache_resize(cache_bytes, true);
+}
+
+lv_obj_t* create(lv_obj_t* parent, const char* path) {
+	lv_obj_t* image = lv_image_create(parent);
+	lv_image_set_src(image, path);
+	lv_obj_t* screen = lv_obj_get_screen(image);
+	lv_obj_remove_event_cb(screen, on_unloaded);  // once per screen
+	lv_obj_add_event_cb(screen, on_unloaded, LV_EVENT_SCREEN_UNLOADED, nullptr);
+	return image;
+}
+
+Stats stats() { return totals; }
+
+}  // namespace image_assets
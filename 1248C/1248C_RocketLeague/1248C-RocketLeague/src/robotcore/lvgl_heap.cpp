@@ -0,0 +1,156 @@
+#include "robotcore/lvgl_heap.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+static_assert(LV_MEM_SIZE >= lvgl_heap::UI_HEAP_BUDGET,
+              "LVGL_HEAP_KB is below UI_HEAP_BUDGET; the screens would run out of LVGL memory");
+
+namespace lvgl_heap {
+
+static std::uint32_t small_used = 0;
+static std::uint32_t small_peak = 0;
+static std::uint32_t failed = 0;
+static std::uint32_t sizes[SIZE_BUCKETS] = {};
+
+#ifdef ROBOTCORE_LVGL_SMALL_POOL
+
+struct alignas(8) Block {
+	union {
+		Block* next;  // while free
+		std::uint8_t bytes[SMALL_BLOCK_BYTES];
+	};
+};
+
+static Block blocks[SMALL_BLOCKS];
+static Block* free_list = nullptr;
+static std::uint32_t never_used = 0;  // blocks[never_used...] haven't been handed out yet
+static bool small_pool = true;
+
+static void count(std::size_t size) {
+	int bucket = 0;
+	while (bucket < SIZE_BUCKETS - 1 && size > (16u << bucket)) bucket++;
+	sizes[bucket]++;
+}
+
+static bool in_pool(const void* data) {
+	return data >= static_cast<const void*>(blocks) && data < static_cast<const void*>(blocks + SMALL_BLOCKS);
+}
+
+static void* take_block(std::size_t size) {
+	if (!small_pool || size == 0 || size > SMALL_BLOCK_BYTES) return nullptr;
+	Block* block = free_list;
+	if (block != nullptr) {
+		free_list = block->next;
+	} else if (never_used < SMALL_BLOCKS) {
+		block = &blocks[never_used++];
+	} else {
+		return nullptr;
+	}
+	small_peak = std::max(small_peak, ++small_used);
+	return block;
+}
+
+static void give_back(void* data) {
+	Block* block = static_cast<Block*>(data);
+	block->next = free_list;
+	free_list = block;
+	small_used--;
+}
+
+static void* checked(void* data, std::size_t size) {
+	if (data == nullptr && size > 0) failed++;
+	return data;
+}
+
+extern "C" {
+
+void* __real_lv_malloc(std::size_t size);
+void* __real_lv_malloc_zeroed(std::size_t size);
+void* __real_lv_realloc(void* data, std::size_t size);
+void __real_lv_free(void* data);
+
+// Called by liblvgl in place of lv_malloc() and friends. Only the linker
+// refers to these, so they are marked used for LTO.
+
+[[gnu::used]] void* __wrap_lv_malloc(std::size_t size) {
+	count(size);
+	if (void* block = take_block(size)) return block;
+	return checked(__real_lv_malloc(size), size);
+}
+
+[[gnu::used]] void* __wrap_lv_malloc_zeroed(std::size_t size) {
+	count(size);
+	if (void* block = take_block(size)) return std::memset(block, 0, SMALL_BLOCK_BYTES);
+	return checked(__real_lv_malloc_zeroed(size), size);
+}
+
+[[gnu::used]] void* __wrap_lv_realloc(void* data, std::size_t size) {
+	if (data == nullptr) return __wrap_lv_malloc(size);
+	if (!in_pool(data)) {
+		if (size > 0) count(size);
+		return checked(__real_lv_realloc(data, size), size);
+	}
+	if (size > 0 && size <= SMALL_BLOCK_BYTES) return data;
+	// Outgrew its block (or size 0, which gives lv_malloc(0)'s placeholder).
+	void* moved = size > 0 ? __wrap_lv_malloc(size) : __real_lv_malloc(0);
+	if (moved == nullptr) return nullptr;
+	if (size > 0) std::memcpy(moved, data, SMALL_BLOCK_BYTES);
+	give_back(data);
+	return moved;
+}
+
+[[gnu::used]] void __wrap_lv_free(void* data) {
+	if (in_pool(data)) {
+		give_back(data);
+	} else {
+		__real_lv_free(data);
+	}
+}
+
+}  // extern "C"
+
+void set_small_pool(bool enabled) { small_pool = enabled; }
+
+#else
+
+void set_small_pool(bool) {}
+
+#endif
+
+Stats stats() {
+	lv_mem_monitor_t monitor;
+	lv_mem_monitor(&monitor);
+	Stats out;
+	out.pool_bytes = monitor.total_size;
+	out.used_bytes = monitor.total_size - monitor.free_size;
+	out.peak_bytes = monitor.max_used;
+	out.biggest_free = monitor.free_biggest_size;
+	out.frag_percent = monitor.frag_pct;
+	out.small_used = small_used;
+	out.small_peak = small_peak;
+	out.failed = failed;
+	std::copy(sizes, sizes + SIZE_BUCKETS, out.sizes);
+	return out;
+}
+
+void print() {
+	Stats heap = stats();
+	std::printf("lvgl heap: %lu/%lu KB used, peak %lu KB (budget %lu KB), biggest free %lu KB, %u%% fragmented\n",
+	            static_cast<unsigned long>(heap.used_bytes / 1024), static_cast<unsigned long>(heap.pool_bytes / 1024),
+	            static_cast<unsigned long>(heap.peak_bytes / 1024), static_cast<unsigned long>(UI_HEAP_BUDGET / 1024),
+	            static_cast<unsigned long>(heap.biggest_free / 1024), heap.frag_percent);
+#ifdef ROBOTCORE_LVGL_SMALL_POOL
+	std::printf("small pool: %lu/%lu blocks of %lu B used, peak %lu; %lu allocations failed\n",
+	            static_cast<unsigned long>(heap.small_used), static_cast<unsigned long>(SMALL_BLOCKS),
+	            static_cast<unsigned long>(SMALL_BLOCK_BYTES), static_cast<unsigned long>(heap.small_peak),
+	            static_cast<unsigned long>(heap.failed));
+	std::printf("allocations by size:");
+	for (int i = 0; i < SIZE_BUCKETS - 1; i++) {
+		std::printf(" <=%lu:%lu", 16ul << i, static_cast<unsigned long>(heap.sizes[i]));
+	}
+	std::printf(" more:%lu\n", static_cast<unsigned long>(heap.sizes[SIZE_BUCKETS - 1]));
+#endif
+}
+
+}  // namespace lvgl_heap
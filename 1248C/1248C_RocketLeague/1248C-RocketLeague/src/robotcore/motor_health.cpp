@@ -0,0 +1,146 @@
+#include "robotcore/motor_health.hpp"
+#include "robotcore/task_monitor.hpp"
+#include "robotcore/robot.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace motor_health {
+
+constexpr std::uint32_t LOOP_MS = 250;
+constexpr float THROTTLE_TEMP_C = 55;  // firmware halves motor power from here
+constexpr float AMBIENT_C = 25;
+
+// First order thermal model: steady state rise is HEAT_C_PER_A2 * I^2 above
+// ambient, reached with time constant TAU_S. Fit these from match logs.
+constexpr float HEAT_C_PER_A2 = 9.0f;
+constexpr float TAU_S = 240.0f;
+constexpr float SENSOR_TRUST = 0.1f;  // how hard each reading pulls the model (readings are coarse)
+
+// Rebalancing: below REBALANCE_S a motor's share drops linearly down to
+// MIN_SHARE, and the others on its side pick it up to at most MAX_SHARE.
+constexpr float REBALANCE_S = 60.0f;
+constexpr float MIN_SHARE = 0.6f;
+constexpr float MAX_SHARE = 1.3f;
+constexpr float WARN_S = 30.0f;
+
+static std::atomic<float> share[DRIVE_MOTORS] = {1, 1, 1, 1, 1, 1};  // even split until the watchdog runs
+static std::atomic<float> time_left[DRIVE_MOTORS];
+static std::atomic<float> model_temp[DRIVE_MOTORS];
+
+static pros::Motor& motor(int i) {
+	return i < DRIVE_MOTORS / 2 ? drive.left_motors[i] : drive.right_motors[i - DRIVE_MOTORS / 2];
+}
+
+// Seconds for the model to go from temp to THROTTLE_TEMP_C at current amps,
+// or -1 if it levels off below the limit.
+static float predict(float temp, float amps) {
+	float steady = AMBIENT_C + HEAT_C_PER_A2 * amps * amps;
+	if (temp >= THROTTLE_TEMP_C) return 0;
+	if (steady <= THROTTLE_TEMP_C) return -1;
+	return -TAU_S * std::log((THROTTLE_TEMP_C - steady) / (temp - steady));
+}
+
+static float share_for(float seconds) {
+	if (seconds < 0 || seconds >= REBALANCE_S) return 1;
+	return MIN_SHARE + (1 - MIN_SHARE) * seconds / REBALANCE_S;
+}
+
+// Gives each side's motors their shares, then scales the cool ones up so the
+// side's total output stays the same where there is room to.
+static void rebalance(const float* seconds) {
+	for (int side = 0; side < 2; side++) {
+		float wanted[DRIVE_MOTORS / 2];
+		float lost = 0;
+		int cool = 0;
+		for (int i = 0; i < DRIVE_MOTORS / 2; i++) {
+			wanted[i] = share_for(seconds[side * DRIVE_MOTORS / 2 + i]);
+			lost += 1 - wanted[i];
+			if (wanted[i] >= 1) cool++;
+		}
+		for (int i = 0; i < DRIVE_MOTORS / 2; i++) {
+			if (wanted[i] >= 1 && cool > 0) wanted[i] = std::min(MAX_SHARE, 1 + lost / cool);
+			share[side * DRIVE_MOTORS / 2 + i] = wanted[i];
+		}
+	}
+}
+
+static void warn(pros::Controller& master, int hottest, float seconds, bool& warned) {
+	if (hottest < 0 || seconds < 0 || seconds > WARN_S) {
+		if (warned) pros::lcd::clear_line(4);
+		warned = false;
+		return;
+	}
+	// print() formats straight onto the line; set_text() would build a std::string after heap_guard::seal().
+	pros::lcd::print(4, "%s%d hot: %.0fC, %.0fs to limit", hottest < DRIVE_MOTORS / 2 ? "L" : "R",
+	                 hottest % (DRIVE_MOTORS / 2) + 1, static_cast<double>(model_temp[hottest].load()),
+	                 static_cast<double>(seconds));
+	if (!warned) master.rumble(seconds <= 0 ? "---" : ". .");
+	warned = true;
+}
+
+static void watchdog_task() {
+	int monitor_id = task_monitor::add("Motor Health");
+	pros::Controller master(pros::E_CONTROLLER_MASTER);
+	bool warned = false;
+	std::uint32_t now = pros::millis();
+
+	for (int i = 0; i < DRIVE_MOTORS; i++) {
+		double reading = motor(i).get_temperature();
+		model_temp[i] = std::isfinite(reading) ? static_cast<float>(reading) : AMBIENT_C;
+	}
+
+	while (true) {
+		float seconds[DRIVE_MOTORS];
+		int hottest = -1;
+		float hottest_s = -1;
+		constexpr float dt = LOOP_MS / 1000.0f;
+
+		for (int i = 0; i < DRIVE_MOTORS; i++) {
+			float amps = motor(i).get_current_draw() / 1000.0f;
+			double reading = motor(i).get_temperature();
+			double efficiency = motor(i).get_efficiency();
+			float temp = model_temp[i];
+
+			// Power that isn't turned into motion turns into heat, so a stalled
+			// motor (low efficiency) heats faster than one spinning freely.
+			float heat_scale = std::isfinite(efficiency) ? 1.5f - static_cast<float>(efficiency) / 200.0f : 1.0f;
+			float steady = AMBIENT_C + HEAT_C_PER_A2 * heat_scale * amps * amps;
+			temp += (steady - temp) * dt / TAU_S;
+			if (std::isfinite(reading) && reading > 0) temp += (static_cast<float>(reading) - temp) * SENSOR_TRUST;
+			model_temp[i] = temp;
+
+			seconds[i] = predict(temp, amps * std::sqrt(heat_scale));
+			time_left[i] = seconds[i];
+			if (seconds[i] >= 0 && (hottest < 0 || seconds[i] < hottest_s)) {
+				hottest = i;
+				hottest_s = seconds[i];
+			}
+		}
+
+		rebalance(seconds);
+		warn(master, hottest, hottest_s, warned);
+		task_monitor::delay_until(monitor_id, &now, LOOP_MS);
+	}
+}
+
+void start() {
+	for (int i = 0; i < DRIVE_MOTORS; i++) {
+		time_left[i] = -1;
+		model_temp[i] = AMBIENT_C;
+	}
+	pros::Task task(watchdog_task, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "Motor Health");
+}
+
+void move_drive(std::int32_t left, std::int32_t right) {
+	for (int i = 0; i < DRIVE_MOTORS / 2; i++) {
+		drive.left_motors[i].move(std::clamp(static_cast<std::int32_t>(left * share[i]), -127, 127));
+		drive.right_motors[i].move(std::clamp(static_cast<std::int32_t>(right * share[DRIVE_MOTORS / 2 + i]), -127, 127));
+	}
+}
+
+float seconds_to_throttle(int i) { return time_left[i]; }
+
+float modeled_temp_c(int i) { return model_temp[i]; }
+
+}  // namespace motor_health
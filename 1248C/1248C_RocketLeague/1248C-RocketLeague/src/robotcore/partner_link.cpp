@@ -0,0 +1,81 @@
+#include "robotcore/partner_link.hpp"
+#include "robotcore/task_monitor.hpp"
+#include "robotcore/robot.hpp"
+#include "robotcore/topic.hpp"
+
+namespace partner {
+
+constexpr const char* LINK_ID = "1248C_alliance";
+constexpr std::uint32_t LOOP_MS = 20;
+constexpr std::uint32_t POSE_PERIOD_MS = 100;  // 12 byte frame at 10 Hz fits the receiver's 520 B/s
+constexpr std::uint32_t PARTNER_TIMEOUT_MS = 1000;
+
+struct Heard {
+	Inbox inbox;
+	std::uint32_t time_ms;
+};
+
+static Topic<Heard> heard_topic;
+
+// Outgoing mailbox, one topic per message type. The link task sends a
+// message whenever its topic has a version it hasn't sent yet.
+static Topic<Pose> out_pose;
+static Topic<Intent> out_intent;
+static Topic<Claim> out_claim;
+
+static void link_task(void* param) {
+	int monitor_id = task_monitor::add("Partner Link");
+	bool transmitter = param != nullptr;
+	pros::Link radio(robot_config.radio, LINK_ID, transmitter ? pros::E_LINK_TX : pros::E_LINK_RX);
+	Channel<pros::Link> channel(radio);
+	Heard heard = {};
+	std::uint32_t last_pose_sent = 0;
+	std::uint32_t pose_version = 0, intent_version = 0, claim_version = 0;  // last versions sent
+	std::uint32_t now = pros::millis();
+
+	while (true) {
+		if (channel.poll(heard.inbox) > 0) {
+			heard.time_ms = now;
+			heard_topic.publish(heard);
+		}
+
+		// Claims and intents go first, they are the ones the partner acts on.
+		// A message that doesn't fit in the radio buffer keeps its old
+		// version so it is tried again next tick.
+		Pose pose;
+		Intent intent;
+		Claim claim;
+		std::uint32_t version = claim_version;
+		if (out_claim.read_if_new(claim, version) && channel.send(MsgType::claim, claim)) claim_version = version;
+		version = intent_version;
+		if (out_intent.read_if_new(intent, version) && channel.send(MsgType::intent, intent)) intent_version = version;
+		version = pose_version;
+		if (now - last_pose_sent >= POSE_PERIOD_MS && out_pose.read_if_new(pose, version) &&
+		    channel.send(MsgType::pose, pose)) {
+			pose_version = version;
+			last_pose_sent = now;
+		}
+
+		task_monitor::delay_until(monitor_id, &now, LOOP_MS);
+	}
+}
+
+void start(bool transmitter) {
+	pros::Task task(link_task, transmitter ? reinterpret_cast<void*>(1) : nullptr, TASK_PRIORITY_DEFAULT,
+	                TASK_STACK_DEPTH_DEFAULT, "Partner Link");
+}
+
+void send_pose(const Pose& pose) { out_pose.publish(pose); }
+
+void send_intent(const Intent& intent) { out_intent.publish(intent); }
+
+void send_claim(const Claim& claim) { out_claim.publish(claim); }
+
+bool get_inbox(Inbox& out) {
+	Heard heard;
+	if (!heard_topic.read(heard)) return false;
+	out = heard.inbox;
+	return pros::millis() - heard.time_ms < PARTNER_TIMEOUT_MS;
+}
+
+}  // namespace partner
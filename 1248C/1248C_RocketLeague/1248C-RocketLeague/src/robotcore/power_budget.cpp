@@ -0,0 +1,143 @@
+#include "robotcore/power_budget.hpp"
+#include "robotcore/motor_io.hpp"
+#include "robotcore/robot.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace power {
+
+// Current limit of a V5 motor, and the battery budget. The budget is
+// FULL_BUDGET_A above OK_MV and falls linearly to MIN_BUDGET_A at SAG_MV,
+// where the brain starts to brown out.
+constexpr float MOTOR_MAX_A = 2.5f;
+constexpr float FULL_BUDGET_A = 20.0f;
+constexpr float MIN_BUDGET_A = 10.0f;
+constexpr std::int32_t OK_MV = 12400;
+constexpr std::int32_t SAG_MV = 11000;
+
+// The battery's measured draw corrects the motor model by up to this factor
+// either way, averaged over about CORRECTION_TICKS allocate() calls. Below
+// MIN_ESTIMATE_A the brain's own draw swamps the motors, so no correction.
+constexpr float MIN_CORRECTION = 0.5f;
+constexpr float MAX_CORRECTION = 2.0f;
+constexpr float CORRECTION_TICKS = 25.0f;
+constexpr float MIN_ESTIMATE_A = 2.0f;
+
+// Pushing: the driver asks for at least this much but the wheels turn
+// slower than this fraction of free speed.
+constexpr std::int32_t PUSH_COMMAND = 100;
+constexpr double PUSH_SPEED_FRACTION = 0.25;
+
+enum Consumer { DRIVE, CONVEYOR, TOP_ROLLER, CONSUMERS };
+
+static const Consumer DRIVE_FIRST[CONSUMERS] = {DRIVE, TOP_ROLLER, CONVEYOR};
+static const Consumer INTAKE_FIRST[CONSUMERS] = {TOP_ROLLER, CONVEYOR, DRIVE};
+
+static float last_budget = FULL_BUDGET_A;
+static bool last_pushing = false;
+static float correction = 1.0f;  // measured battery current over the model's estimate
+static float last_estimate = 0;  // model current of the commands last handed out
+
+// A motor draws current in proportion to the command minus its back-EMF,
+// which goes with speed: one already turning at the commanded speed draws
+// almost nothing, a stalled or reversing one draws up to its limit. speed is
+// the motor's velocity as a fraction of its free speed.
+static float motor_amps(std::int32_t command, float speed) {
+	if (command == 0) return 0;  // coasting or braking, not driven
+	return std::min(std::abs(command / 127.0f - speed), 1.0f) * MOTOR_MAX_A;
+}
+
+// The command that draws fraction of what command would, for a motor turning
+// at speed: part of the way from its back-EMF to the command.
+static std::int32_t scaled(std::int32_t command, float speed, float fraction) {
+	if (fraction >= 1 || command == 0) return command;
+	float applied = speed + (command / 127.0f - speed) * fraction;
+	return static_cast<std::int32_t>(std::clamp(applied, -1.0f, 1.0f) * 127);
+}
+
+struct Side {
+	float amps;
+	float speed;  // average over the motors, for scaled()
+	float pace;   // average of each motor's |speed|, for drive_pushing()
+};
+
+static Side side_demand(const pros::MotorGroup& side, std::int32_t command) {
+	double rpm[DRIVE_MOTORS_PER_SIDE];
+	int count = motor_io::actual_velocity(side, rpm);
+	double max_rpm = drive_max_rpm();
+	Side out = {0, 0, 0};
+	for (int i = 0; i < count; i++) {
+		float speed = static_cast<float>(rpm[i] / max_rpm);
+		out.amps += motor_amps(command, speed);
+		out.speed += speed / count;
+		out.pace += std::abs(speed) / count;
+	}
+	return out;
+}
+
+static float motor_speed(const pros::Motor& motor) {
+	return static_cast<float>(motor.get_actual_velocity() / cartridge_rpm(motor.get_gearing()));
+}
+
+static float battery_budget() {
+	std::int32_t mv = pros::battery::get_voltage();
+	std::int32_t ma = pros::battery::get_current();
+	float budget = FULL_BUDGET_A;
+	if (mv > 0 && mv < OK_MV) {
+		float t = static_cast<float>(std::max(mv, SAG_MV) - SAG_MV) / (OK_MV - SAG_MV);
+		budget = MIN_BUDGET_A + (FULL_BUDGET_A - MIN_BUDGET_A) * t;
+	}
+	// The model is rough. Compare what the battery says we drew with what the
+	// model said the last commands would draw, and give out budget in model
+	// amps: if the model reads high the budget grows, if it reads low it
+	// shrinks.
+	if (ma > 0 && last_estimate >= MIN_ESTIMATE_A) {
+		float ratio = std::clamp(ma / 1000.0f / last_estimate, MIN_CORRECTION, MAX_CORRECTION);
+		correction += (ratio - correction) / CORRECTION_TICKS;
+	}
+	return budget / correction;
+}
+
+// Uses the per-motor readings side_demand() already took, so one slipping or
+// stalled motor on a side counts and no motor is read twice per tick.
+static bool drive_pushing(const Commands& wanted, const Side& left, const Side& right) {
+	std::int32_t command = std::max(std::abs(wanted.left), std::abs(wanted.right));
+	if (command < PUSH_COMMAND) return false;
+	return (left.pace + right.pace) / 2 < PUSH_SPEED_FRACTION;
+}
+
+Commands allocate(const Commands& wanted) {
+	Side left_side = side_demand(left_mg, wanted.left);
+	Side right_side = side_demand(right_mg, wanted.right);
+	float conveyor_speed = motor_speed(conveyor);
+	float top_roller_speed = motor_speed(top_roller);
+
+	float demand[CONSUMERS];
+	demand[DRIVE] = left_side.amps + right_side.amps;
+	demand[CONVEYOR] = motor_amps(wanted.conveyor, conveyor_speed);
+	demand[TOP_ROLLER] = motor_amps(wanted.top_roller, top_roller_speed);
+
+	last_budget = battery_budget();
+	last_pushing = drive_pushing(wanted, left_side, right_side);
+	const Consumer* order = last_pushing ? DRIVE_FIRST : INTAKE_FIRST;
+
+	float scale[CONSUMERS];
+	float left = last_budget;
+	for (int i = 0; i < CONSUMERS; i++) {
+		Consumer consumer = order[i];
+		float granted = std::min(demand[consumer], left);
+		scale[consumer] = demand[consumer] > 0 ? granted / demand[consumer] : 1;
+		left -= granted;
+	}
+	last_estimate = last_budget - left;
+
+	return {scaled(wanted.left, left_side.speed, scale[DRIVE]), scaled(wanted.right, right_side.speed, scale[DRIVE]),
+	        scaled(wanted.conveyor, conveyor_speed, scale[CONVEYOR]),
+	        scaled(wanted.top_roller, top_roller_speed, scale[TOP_ROLLER])};
+}
+
+float budget_amps() { return last_budget; }
+
+bool pushing() { return last_pushing; }
+
+}  // namespace power
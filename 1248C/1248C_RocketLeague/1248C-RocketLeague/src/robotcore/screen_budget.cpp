@@ -0,0 +1,194 @@
+#include "robotcore/screen_budget.hpp"
+#include <algorithm>
+
+namespace screen_budget {
+
+struct Dirty {
+	lv_area_t area;
+	std::uint8_t waited;  // frames this area has been left for later
+	Priority priority;
+};
+
+static lv_display_t* display = nullptr;
+static lv_timer_t* wake_timer = nullptr;
+static std::uint32_t budget = DEFAULT_PIXEL_BUDGET;
+static lv_obj_t* low_priority[MAX_LOW_PRIORITY];
+static Dirty dirty[LV_INV_BUF_SIZE * 2];
+static Dirty waiting[LV_INV_BUF_SIZE];
+static int waiting_count = 0;
+static Stats totals = {};
+
+static bool in_low_priority(const lv_area_t& area) {
+	lv_obj_t* screen = lv_display_get_screen_active(display);
+	for (lv_obj_t* obj : low_priority) {
+		if (obj == nullptr || lv_obj_get_screen(obj) != screen) continue;
+		lv_area_t coords;
+		lv_obj_get_coords(obj, &coords);
+		std::int32_t extra = lv_obj_get_ext_draw_size(obj);
+		lv_area_increase(&coords, extra, extra);
+		if (lv_area_is_in(&area, &coords, 0)) return true;
+	}
+	return false;
+}
+
+static bool full_screen(const lv_area_t& area) {
+	return lv_area_get_width(&area) >= lv_display_get_horizontal_resolution(display) &&
+	       lv_area_get_height(&area) >= lv_display_get_vertical_resolution(display);
+}
+
+// Draw order: anything that has waited too long, then normal, then low.
+static int rank(const Dirty& entry) {
+	if (entry.waited >= MAX_WAIT_FRAMES) return 0;
+	return entry.priority == Priority::normal ? 1 : 2;
+}
+
+static int merge(int count) {
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (int i = 0; i < count && !changed; i++) {
+			for (int j = i + 1; j < count; j++) {
+				lv_area_t joined;
+				lv_area_join(&joined, &dirty[i].area, &dirty[j].area);
+				if (lv_area_get_size(&joined) >
+				    lv_area_get_size(&dirty[i].area) + lv_area_get_size(&dirty[j].area) + MERGE_OVERHEAD_PX) {
+					continue;
+				}
+				dirty[i].area = joined;
+				dirty[i].waited = std::max(dirty[i].waited, dirty[j].waited);
+				dirty[i].priority = std::min(dirty[i].priority, dirty[j].priority);
+				dirty[j] = dirty[--count];
+				totals.merged++;
+				changed = true;
+				break;
+			}
+		}
+	}
+	return count;
+}
+
+static void wait(const Dirty& entry) {
+	if (waiting_count < LV_INV_BUF_SIZE) {
+		waiting[waiting_count++] = entry;
+	} else {
+		// Out of room, fold it into the last one.
+		Dirty& last = waiting[LV_INV_BUF_SIZE - 1];
+		lv_area_join(&last.area, &last.area, &entry.area);
+		last.waited = std::max(last.waited, entry.waited);
+		last.priority = std::min(last.priority, entry.priority);
+	}
+	totals.deferred++;
+}
+
+// Runs on the LVGL task at the start of every refresh, before LVGL joins
+// and draws the invalidated areas.
+static void on_refresh(lv_event_t*) {
+	// Layout changes invalidate too; get them in now so they are budgeted.
+	lv_obj_update_layout(lv_display_get_screen_active(display));
+	lv_obj_update_layout(lv_display_get_layer_bottom(display));
+	lv_obj_update_layout(lv_display_get_layer_top(display));
+	lv_obj_update_layout(lv_display_get_layer_sys(display));
+
+	int count = 0;
+	bool whole_screen = false;
+	for (std::uint32_t i = 0; i < display->inv_p; i++) {
+		if (display->inv_area_joined[i]) continue;
+		whole_screen |= full_screen(display->inv_areas[i]);
+		dirty[count++] = {display->inv_areas[i], 0, Priority::normal};
+	}
+	if (whole_screen) {
+		// A new screen or an overflow: everything gets drawn, nothing waits.
+		waiting_count = 0;
+		totals.frames++;
+		std::uint32_t pixels = lv_display_get_horizontal_resolution(display) *
+		                       lv_display_get_vertical_resolution(display);
+		totals.pixels += pixels;
+		totals.max_pixels = std::max(totals.max_pixels, pixels);
+		return;
+	}
+	for (int i = 0; i < waiting_count; i++) dirty[count++] = waiting[i];
+	waiting_count = 0;
+	if (count == 0) return;
+
+	for (int i = 0; i < count; i++) {
+		dirty[i].priority = in_low_priority(dirty[i].area) ? Priority::low : Priority::normal;
+	}
+	count = merge(count);
+	std::sort(dirty, dirty + count, [](const Dirty& a, const Dirty& b) {
+		if (rank(a) != rank(b)) return rank(a) < rank(b);
+		return a.waited > b.waited;
+	});
+
+	std::uint32_t drawn = 0;
+	std::uint32_t kept = 0;
+	for (int i = 0; i < count; i++) {
+		std::uint32_t size = lv_area_get_size(&dirty[i].area);
+		bool fits = drawn + size <= budget && kept < LV_INV_BUF_SIZE;
+		if (kept == 0 || fits) {
+			if (size > budget) totals.over_budget++;
+			display->inv_areas[kept] = dirty[i].area;
+			display->inv_area_joined[kept] = 0;
+			kept++;
+			drawn += size;
+		} else {
+			dirty[i].waited++;
+			wait(dirty[i]);
+		}
+	}
+	display->inv_p = kept;
+	if (waiting_count > 0) lv_timer_resume(wake_timer);
+
+	totals.frames++;
+	totals.pixels += drawn;
+	totals.max_pixels = std::max(totals.max_pixels, drawn);
+}
+
+// LVGL pauses the refresh timer once it has drawn, and only an invalidation
+// starts it again, so on a screen that stopped changing the areas left
+// waiting would never be drawn. on_refresh() starts this one-shot instead. It
+// runs after the refresh has returned, so LVGL's pause can't undo it. While
+// the display has invalidation turned off nothing should be drawn, and
+// whoever turns it back on has to redraw the screen anyway.
+static void wake(lv_timer_t* timer) {
+	lv_timer_pause(timer);
+	if (lv_display_is_invalidation_enabled(display)) lv_timer_resume(lv_display_get_refr_timer(display));
+}
+
+static void forget(lv_obj_t* obj) {
+	for (lv_obj_t*& entry : low_priority) {
+		if (entry == obj) entry = nullptr;
+	}
+}
+
+static void on_delete(lv_event_t* event) { forget(lv_event_get_target_obj(event)); }
+
+void start(std::uint32_t pixel_budget) {
+	display = lv_display_get_default();
+	budget = pixel_budget;
+	wake_timer = lv_timer_create(wake, 0, nullptr);
+	lv_timer_pause(wake_timer);
+	lv_display_add_event_cb(display, on_refresh, LV_EVENT_REFR_START, nullptr);
+}
+
+void set_budget(std::uint32_t pixels) { budget = pixels; }
+
+void set_priority(lv_obj_t* obj, Priority priority) {
+	forget(obj);
+	lv_obj_remove_event_cb(obj, on_delete);
+	if (priority != Priority::low) return;
+	for (lv_obj_t*& entry : low_priority) {
+		if (entry == nullptr) {
+			entry = obj;
+			lv_obj_add_event_cb(obj, on_delete, LV_EVENT_DELETE, nullptr);
+			return;
+		}
+	}
+}
+
+Stats stats() {
+	Stats out = totals;
+	out.waiting = waiting_count;
+	return out;
+}
+
+}  // namespace screen_budget
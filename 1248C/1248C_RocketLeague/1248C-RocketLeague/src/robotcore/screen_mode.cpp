@@ -0,0 +1,77 @@
+#include "robotcore/screen_mode.hpp"
+#include "liblvgl/lvgl.h"
+#include <atomic>
+
+namespace screen_mode {
+
+static lv_display_t* display = nullptr;
+static lv_timer_t* refresh_timer = nullptr;
+static std::uint32_t full_refresh_ms = LV_DEF_REFR_PERIOD;
+static std::uint32_t full_input_ms = LV_DEF_REFR_PERIOD;
+static Mode applied = Mode::full;                 // LVGL task only
+static std::atomic<Mode> requested{Mode::full};  // from any task
+
+// Every input device has its own read timer.
+static void set_input(std::uint32_t period_ms, bool paused) {
+	for (lv_indev_t* indev = lv_indev_get_next(nullptr); indev != nullptr; indev = lv_indev_get_next(indev)) {
+		lv_timer_t* timer = lv_indev_get_read_timer(indev);
+		if (timer == nullptr) continue;
+		lv_timer_set_period(timer, period_ms);
+		if (paused) {
+			lv_timer_pause(timer);
+		} else {
+			lv_timer_resume(timer);
+		}
+	}
+}
+
+// Runs on the LVGL task, the only place the timers are touched.
+static void apply(lv_timer_t*) {
+	Mode next = requested.load(std::memory_order_relaxed);
+	if (refresh_timer == nullptr || next == applied) return;
+	switch (next) {
+		case Mode::full:
+			lv_timer_set_period(refresh_timer, full_refresh_ms);
+			set_input(full_input_ms, false);
+			break;
+		case Mode::minimal:
+			lv_timer_set_period(refresh_timer, MINIMAL_REFRESH_MS);
+			set_input(MINIMAL_INPUT_MS, false);
+			break;
+		case Mode::frozen:
+			// Pausing the refresh timer isn't enough: every invalidation
+			// resumes it. With invalidation off nothing is queued to draw.
+			lv_display_enable_invalidation(display, false);
+			set_input(full_input_ms, true);
+			break;
+	}
+	if (next != Mode::frozen) {
+		if (applied == Mode::frozen) {
+			// Nothing that changed while frozen was recorded, so redraw it all.
+			lv_display_enable_invalidation(display, true);
+			lv_obj_invalidate(lv_display_get_screen_active(display));
+		}
+		lv_timer_resume(refresh_timer);
+		lv_timer_ready(refresh_timer);  // catch up now, not a period from now
+	}
+	applied = next;
+}
+
+void start() {
+	static lv_timer_t* apply_timer = nullptr;
+	if (apply_timer == nullptr) apply_timer = lv_timer_create(apply, APPLY_MS, nullptr);
+	display = lv_display_get_default();
+	refresh_timer = lv_display_get_refr_timer(display);
+	if (refresh_timer != nullptr) full_refresh_ms = refresh_timer->period;
+	lv_indev_t* indev = lv_indev_get_next(nullptr);
+	if (indev != nullptr && lv_indev_get_read_timer(indev) != nullptr) {
+		full_input_ms = lv_indev_get_read_timer(indev)->period;
+	}
+	applied = Mode::full;
+}
+
+void set(Mode next) { requested.store(next, std::memory_order_relaxed); }
+
+Mode get() { return requested.load(std::memory_order_relaxed); }
+
+}  // namespace screen_mode
@@ -0,0 +1,82 @@
+#include "robotcore/screen_rgb565.hpp"
+#include "pros/screen.hpp"
+#include <algorithm>
+
+namespace screen_rgb565 {
+
+// 4x4 ordered dither thresholds, 0-15.
+static constexpr std::uint8_t BAYER[4][4] = {{0, 8, 2, 10}, {12, 4, 14, 6}, {3, 11, 1, 9}, {15, 7, 13, 5}};
+
+static bool dither_on = true;
+
+// LVGL makes RGB565 by dropping the low bits, so level v came from 8-bit
+// values v << 3 up to 7 more (3 more for green). Plain widening copies the
+// top bits down so 0 and full stay 0 and 255; dithering picks a value in the
+// range by the threshold instead.
+static inline std::uint32_t widen5(std::uint32_t v, std::uint32_t threshold, bool dither) {
+	if (!dither || v == 0 || v == 31) return (v << 3) | (v >> 2);
+	return (v << 3) + (threshold >> 1);
+}
+
+static inline std::uint32_t widen6(std::uint32_t v, std::uint32_t threshold, bool dither) {
+	if (!dither || v == 0 || v == 63) return (v << 2) | (v >> 4);
+	return (v << 2) + (threshold >> 2);
+}
+
+void expand(const std::uint8_t* src, std::uint32_t src_stride, std::uint32_t* dest, std::uint32_t dest_stride,
+            const lv_area_t& area, bool dither) {
+	std::int32_t width = lv_area_get_width(&area);
+	for (std::int32_t y = area.y1; y <= area.y2; y++) {
+		const std::uint16_t* in = reinterpret_cast<const std::uint16_t*>(src);
+		const std::uint8_t* thresholds = BAYER[y & 3];
+		for (std::int32_t i = 0; i < width; i++) {
+			std::uint32_t pixel = in[i];
+			std::uint32_t threshold = thresholds[(area.x1 + i) & 3];
+			dest[i] = 0xFF000000 | widen5(pixel >> 11, threshold, dither) << 16 |
+			          widen6((pixel >> 5) & 0x3F, threshold, dither) << 8 | widen5(pixel & 0x1F, threshold, dither);
+		}
+		src += src_stride;
+		dest += dest_stride;
+	}
+}
+
+void set_dither(bool dither) {
+	dither_on = dither;
+	lv_obj_invalidate(lv_screen_active());
+}
+
+#ifdef ROBOTCORE_SCREEN_RGB565
+
+alignas(LV_DRAW_BUF_ALIGN) static std::uint8_t draw_buf[LV_HOR_RES_MAX * DRAW_LINES * 2];
+static std::uint32_t flush_buf[LV_HOR_RES_MAX * FLUSH_LINES];
+
+// Runs on the LVGL task.
+static void flush(lv_display_t* display, const lv_area_t* area, std::uint8_t* pixels) {
+	std::int32_t width = lv_area_get_width(area);
+	std::uint32_t stride = lv_draw_buf_width_to_stride(width, LV_COLOR_FORMAT_RGB565);
+	lv_area_t chunk = *area;
+	for (chunk.y1 = area->y1; chunk.y1 <= area->y2; chunk.y1 += FLUSH_LINES) {
+		chunk.y2 = std::min(chunk.y1 + FLUSH_LINES - 1, area->y2);
+		expand(pixels + (chunk.y1 - area->y1) * stride, stride, flush_buf, width, chunk, dither_on);
+		pros::screen::copy_area(chunk.x1, chunk.y1, chunk.x2, chunk.y2, flush_buf, width);
+	}
+	lv_display_flush_ready(display);
+}
+
+void start(bool dither) {
+	lv_display_t* display = lv_display_get_default();
+	if (display == nullptr) return;
+	dither_on = dither;
+	lv_display_set_color_format(display, LV_COLOR_FORMAT_RGB565);
+	lv_display_set_buffers(display, draw_buf, nullptr, sizeof(draw_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+	lv_display_set_flush_cb(display, flush);
+	lv_obj_invalidate(lv_screen_active());
+}
+
+#else
+
+void start(bool) {}
+
+#endif
+
+}  // namespace screen_rgb565
@@ -0,0 +1,121 @@
+#include "robotcore/settle.hpp"
+#include "robotcore/motor_io.hpp"
+#include "robotcore/robot.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace settle {
+
+static Result history[LOG_SIZE];
+static int logged = 0;
+
+// Average over a side's motors. A motor that can't be read counts as 0.
+template <std::size_t N>
+static double average(const double (&values)[N], int count) {
+	double sum = 0;
+	for (int i = 0; i < count; i++) {
+		if (std::isfinite(values[i])) sum += values[i];
+	}
+	return count > 0 ? sum / count : 0;
+}
+
+static double rpm(const pros::MotorGroup& side) {
+	double values[DRIVE_MOTORS_PER_SIDE];
+	return average(values, motor_io::actual_velocity(side, values));
+}
+
+static double degrees(const pros::MotorGroup& side) {
+	double values[DRIVE_MOTORS_PER_SIDE];
+	return average(values, motor_io::position(side, values));
+}
+
+static Mode choose(Next next, double speed, double slow_rpm) {
+	if (speed < slow_rpm) return Mode::brake;
+	if (next == Next::turn || next == Next::action || next == Next::unknown) return Mode::hold;
+	return Mode::brake;
+}
+
+static void set_mode(Mode mode) {
+	pros::MotorBrake brake = mode == Mode::hold    ? pros::MotorBrake::hold
+	                         : mode == Mode::brake ? pros::MotorBrake::brake
+	                                               : pros::MotorBrake::coast;
+	left_mg.set_brake_mode_all(brake);
+	right_mg.set_brake_mode_all(brake);
+}
+
+Result stop(Next next) {
+	std::uint32_t start = pros::millis();
+	double left_start = degrees(left_mg), right_start = degrees(right_mg);
+	double left_rpm = rpm(left_mg), right_rpm = rpm(right_mg);
+	const double max_rpm = drive_max_rpm();
+	const double slow_rpm = SLOW_FRACTION * max_rpm;
+
+	Result result = {};
+	result.start_rpm = std::max(std::abs(left_rpm), std::abs(right_rpm));
+	result.mode = choose(next, result.start_rpm, slow_rpm);
+	set_mode(result.mode);
+
+	// Active braking: push against the motion in proportion to the speed left.
+	if (result.start_rpm > FAST_FRACTION * max_rpm) {
+		result.active_brake = true;
+		std::uint32_t now = start;
+		while (pros::millis() - start < ACTIVE_MAX_MS && std::max(std::abs(left_rpm), std::abs(right_rpm)) > slow_rpm) {
+			left_mg.move(std::clamp(static_cast<int>(-left_rpm / max_rpm * 127 * ACTIVE_GAIN), -127, 127));
+			right_mg.move(std::clamp(static_cast<int>(-right_rpm / max_rpm * 127 * ACTIVE_GAIN), -127, 127));
+			pros::Task::delay_until(&now, LOOP_MS);
+			left_rpm = rpm(left_mg);
+			right_rpm = rpm(right_mg);
+		}
+	}
+	left_mg.brake();
+	right_mg.brake();
+
+	// Closed-loop settle on the measured speed instead of a fixed dwell.
+	std::uint32_t now = pros::millis();
+	std::uint32_t still_since = now;
+	while (true) {
+		pros::Task::delay_until(&now, LOOP_MS);
+		if (std::max(std::abs(rpm(left_mg)), std::abs(rpm(right_mg))) > STILL_RPM) still_since = now;
+		if (now - still_since >= STILL_MS) break;
+		if (now - start >= TIMEOUT_MS) {
+			result.timed_out = true;
+			break;
+		}
+	}
+
+	result.settle_ms = pros::millis() - start;
+	result.drift_deg =
+	    (std::abs(degrees(left_mg) - left_start) + std::abs(degrees(right_mg) - right_start)) / 2;
+	history[logged % LOG_SIZE] = result;
+	logged++;
+	return result;
+}
+
+void release() { set_mode(Mode::coast); }
+
+int count() { return std::min(logged, LOG_SIZE); }
+
+Result get(int i) { return history[(logged - count() + i) % LOG_SIZE]; }
+
+void clear() { logged = 0; }
+
+void print() {
+	static const char* const mode_names[] = {"coast", "brake", "hold"};
+	std::uint32_t worst = 0, total = 0;
+	for (int i = 0; i < count(); i++) {
+		Result result = get(i);
+		std::printf("stop %2d: %4lu ms %6.1f deg drift from %5.0f rpm, %s%s%s\n", i,
+		            static_cast<unsigned long>(result.settle_ms), result.drift_deg, result.start_rpm,
+		            mode_names[static_cast<int>(result.mode)], result.active_brake ? " + active" : "",
+		            result.timed_out ? ", timed out" : "");
+		worst = std::max(worst, result.settle_ms);
+		total += result.settle_ms;
+	}
+	if (count() > 0) {
+		std::printf("%d stops, worst %lu ms, average %lu ms\n", count(), static_cast<unsigned long>(worst),
+		            static_cast<unsigned long>(total / count()));
+	}
+}
+
+}  // namespace settle
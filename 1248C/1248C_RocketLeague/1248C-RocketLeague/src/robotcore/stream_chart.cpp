@@ -0,0 +1,205 @@
+#include "robotcore/stream_chart.hpp"
+#include "liblvgl/misc/lv_circle_buf.h"  // not in lvgl.h
+#include <algorithm>
+
+namespace stream_chart {
+
+struct Column {
+	std::int32_t low[MAX_SERIES];
+	std::int32_t high[MAX_SERIES];
+};
+
+struct Chart {
+	lv_obj_t* obj;                 // nullptr if this place is free
+	lv_circle_buf_t* columns;      // oldest first, never more than slots - GAP_COLUMNS
+	std::uint32_t slots;           // pixel columns across the chart
+	std::uint32_t head;            // slot the next column goes in
+	std::int32_t min;
+	std::int32_t max;
+	std::uint32_t samples_per_column;
+	int series;
+	lv_color_t colors[MAX_SERIES];
+	Column pending;
+	std::uint32_t pending_samples;
+	std::uint32_t dirty_from;      // first slot changed since the last flush()
+	std::uint32_t dirty_count;     // slots from there on, wrapping
+};
+
+static Chart charts[MAX_CHARTS];
+
+static Chart* find(lv_obj_t* obj) {
+	if (obj == nullptr) return nullptr;  // a create() that failed
+	for (Chart& chart : charts) {
+		if (chart.obj == obj) return &chart;
+	}
+	return nullptr;
+}
+
+// New columns and the gap move forward one slot at a time, so everything
+// changed since the last flush() is one run of slots, possibly wrapping.
+static void mark_dirty(Chart& chart, std::uint32_t slot) {
+	if (chart.dirty_count == 0) {
+		chart.dirty_from = slot;
+		chart.dirty_count = 1;
+		return;
+	}
+	std::uint32_t offset = (slot + chart.slots - chart.dirty_from) % chart.slots;
+	if (offset >= chart.dirty_count) chart.dirty_count = std::min(offset + 1, chart.slots);
+}
+
+static void invalidate_slots(const Chart& chart, std::uint32_t first, std::uint32_t count) {
+	lv_area_t strip;
+	lv_obj_get_content_coords(chart.obj, &strip);
+	strip.x1 += first;
+	strip.x2 = strip.x1 + count - 1;
+	lv_obj_invalidate_area(chart.obj, &strip);
+}
+
+static std::int32_t to_y(const Chart& chart, const lv_area_t& content, std::int32_t value) {
+	value = std::clamp(value, chart.min, chart.max);
+	std::int64_t scaled = static_cast<std::int64_t>(value - chart.min) * (lv_area_get_height(&content) - 1);
+	return content.y2 - static_cast<std::int32_t>(scaled / (chart.max - chart.min));
+}
+
+// Only the columns inside the area being redrawn, which for a new sample is one.
+static void on_draw(lv_event_t* event) {
+	const Chart& chart = *static_cast<Chart*>(lv_event_get_user_data(event));
+	lv_layer_t* layer = lv_event_get_layer(event);
+	lv_area_t content;
+	lv_obj_get_content_coords(chart.obj, &content);
+	lv_area_t visible;
+	if (!lv_area_intersect(&visible, &content, &layer->_clip_area)) return;
+
+	std::uint32_t size = lv_circle_buf_size(chart.columns);
+	std::uint32_t oldest = (chart.head + chart.slots - size) % chart.slots;
+	lv_draw_rect_dsc_t line;
+	lv_draw_rect_dsc_init(&line);
+	for (std::int32_t x = visible.x1; x <= visible.x2; x++) {
+		std::uint32_t index = (x - content.x1 + chart.slots - oldest) % chart.slots;
+		if (index >= size) continue;  // the gap, or not written yet
+		Column column;
+		Column previous;
+		lv_circle_buf_peek_at(chart.columns, index, &column);
+		bool joined = index > 0 && lv_circle_buf_peek_at(chart.columns, index - 1, &previous) == LV_RESULT_OK;
+		for (int s = 0; s < chart.series; s++) {
+			std::int32_t low = column.low[s];
+			std::int32_t high = column.high[s];
+			if (joined) {
+				// Reach the previous column so the trace has no breaks.
+				low = std::min(low, previous.high[s]);
+				high = std::max(high, previous.low[s]);
+			}
+			lv_area_t area = {x, to_y(chart, content, high), x, to_y(chart, content, low)};
+			line.bg_color = chart.colors[s];
+			lv_draw_rect(layer, &line, &area);
+		}
+	}
+}
+
+static void on_delete(lv_event_t* event) {
+	Chart& chart = *static_cast<Chart*>(lv_event_get_user_data(event));
+	lv_circle_buf_destroy(chart.columns);
+	chart = {};
+}
+
+lv_obj_t* create(lv_obj_t* parent, std::int32_t width, std::int32_t height, std::int32_t min, std::int32_t max,
+                 std::uint32_t samples_per_column) {
+	Chart* chart = nullptr;
+	for (Chart& free : charts) {
+		if (free.obj == nullptr) {
+			chart = &free;
+			break;
+		}
+	}
+	if (chart == nullptr) return nullptr;
+
+	lv_obj_t* obj = lv_obj_create(parent);
+	lv_obj_set_size(obj, width, height);
+	lv_obj_set_style_pad_all(obj, 0, 0);
+	lv_obj_set_style_radius(obj, 0, 0);  // columns go right into the corners
+	lv_obj_remove_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+	lv_obj_remove_flag(obj, LV_OBJ_FLAG_CLICKABLE);  // taps go to the screen
+	std::int32_t slots = width - 2 * lv_obj_get_style_border_width(obj, LV_PART_MAIN);
+	if (slots <= static_cast<std::int32_t>(GAP_COLUMNS)) {
+		lv_obj_delete(obj);
+		return nullptr;
+	}
+	lv_circle_buf_t* columns = lv_circle_buf_create(slots - GAP_COLUMNS, sizeof(Column));
+	if (columns == nullptr) {
+		lv_obj_delete(obj);
+		return nullptr;
+	}
+
+	*chart = {};
+	chart->obj = obj;
+	chart->columns = columns;
+	chart->slots = slots;
+	chart->min = min;
+	chart->max = max > min ? max : min + 1;
+	chart->samples_per_column = samples_per_column > 0 ? samples_per_column : 1;
+	lv_obj_add_event_cb(obj, on_draw, LV_EVENT_DRAW_MAIN, chart);
+	lv_obj_add_event_cb(obj, on_delete, LV_EVENT_DELETE, chart);
+	return obj;
+}
+
+void add_series(lv_obj_t* obj, lv_color_t color) {
+	Chart* chart = find(obj);
+	if (chart == nullptr || chart->series == MAX_SERIES) return;
+	chart->colors[chart->series++] = color;
+}
+
+void push(lv_obj_t* obj, std::initializer_list<std::int32_t> values) {
+	Chart* chart = find(obj);
+	if (chart == nullptr) return;
+	int s = 0;
+	for (std::int32_t value : values) {
+		if (s == chart->series) break;
+		if (chart->pending_samples == 0) {
+			chart->pending.low[s] = chart->pending.high[s] = value;
+		} else {
+			chart->pending.low[s] = std::min(chart->pending.low[s], value);
+			chart->pending.high[s] = std::max(chart->pending.high[s], value);
+		}
+		s++;
+	}
+	if (++chart->pending_samples < chart->samples_per_column) return;
+	chart->pending_samples = 0;
+
+	std::uint32_t gap_end = chart->slots;  // none until the buffer is full
+	if (lv_circle_buf_is_full(chart->columns)) {
+		// The oldest column becomes the far end of the gap.
+		gap_end = (chart->head + chart->slots - lv_circle_buf_size(chart->columns)) % chart->slots;
+		lv_circle_buf_skip(chart->columns);
+	}
+	lv_circle_buf_write(chart->columns, &chart->pending);
+	// The new column first: the dirty run starts there and reaches forward
+	// across the gap to its far end.
+	mark_dirty(*chart, chart->head);
+	if (gap_end != chart->slots) mark_dirty(*chart, gap_end);
+	chart->head = (chart->head + 1) % chart->slots;
+}
+
+void flush(lv_obj_t* obj) {
+	Chart* chart = find(obj);
+	if (chart == nullptr || chart->dirty_count == 0) return;
+	std::uint32_t to_end = chart->slots - chart->dirty_from;
+	if (chart->dirty_count <= to_end) {
+		invalidate_slots(*chart, chart->dirty_from, chart->dirty_count);
+	} else {
+		invalidate_slots(*chart, chart->dirty_from, to_end);
+		invalidate_slots(*chart, 0, chart->dirty_count - to_end);
+	}
+	chart->dirty_count = 0;
+}
+
+void clear(lv_obj_t* obj) {
+	Chart* chart = find(obj);
+	if (chart == nullptr) return;
+	lv_circle_buf_reset(chart->columns);
+	chart->head = 0;
+	chart->pending_samples = 0;
+	chart->dirty_count = 0;
+	lv_obj_invalidate(obj);
+}
+
+}  // namespace stream_chart
@@ -0,0 +1,213 @@
+#include "robotcore/task_monitor.hpp"
+#include "main.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+namespace task_monitor {
+
+constexpr std::uint32_t REPORT_MS = 1000;
+constexpr std::uint32_t PAINT = 0xA5A5A5A5;
+// PROS doesn't give out where a task's stack starts, only its depth, so
+// add() works out the bottom from its own frame: at most stack_depth below
+// the top, and the top is however deep the task already was when it called
+// add() above that. ENTRY_ALLOWANCE is how deep that is allowed to be. This
+// much of the top of the stack is never painted, so the painted range stays
+// inside the stack as long as add() is called within ENTRY_ALLOWANCE of the
+// task's entry; a task function, or opcontrol() under PROS's wrapper, uses a
+// few hundred bytes before it. Anything deeper would paint past the bottom of
+// the stack into the heap, so keep add() the first call in the task
+// function. A stack too small to leave anything after the allowance is not
+// painted, and reports all of it as free since nothing is known.
+constexpr std::uintptr_t ENTRY_ALLOWANCE = 8 * 1024;
+// Left unpainted just below add()'s local so its own frame is never touched.
+constexpr std::uintptr_t FRAME_GUARD = 256;
+
+struct Slot {
+	bool used;
+	pros::task_t handle;
+	char task_name[TASK_NAME_MAX_LEN];  // the RTOS name, to check the task is still alive
+	const char* name;
+	std::uint32_t stack_size;
+	const std::uint32_t* paint_low;
+	const std::uint32_t* paint_high;
+	std::uint32_t woke_us;  // only the task itself touches this
+	std::atomic<std::uint32_t> awake_us;
+	std::atomic<std::uint32_t> wakes;
+};
+
+static Slot slots[MAX_TASKS];
+static std::atomic<int> slot_count{0};
+static pros::Mutex add_mutex;
+static Stats reports[MAX_TASKS];
+static pros::Mutex report_mutex;
+static std::atomic<bool> serial{true};
+
+[[gnu::noinline]] int add(const char* name, std::uint32_t stack_depth) {
+	std::lock_guard<pros::Mutex> lock(add_mutex);
+	// The same name takes over its slot, otherwise the first free one.
+	int count = slot_count.load();
+	int id = 0;
+	while (id < count && !(slots[id].used && std::strcmp(slots[id].name, name) == 0)) id++;
+	if (id == count) {
+		id = 0;
+		while (id < count && slots[id].used) id++;
+	}
+	if (id == MAX_TASKS) return -1;
+
+	// The stack grows down from somewhere less than ENTRY_ALLOWANCE above
+	// here. Paint everything between its lowest possible end and this frame.
+	volatile std::uint32_t here = 0;
+	std::uintptr_t sp = reinterpret_cast<std::uintptr_t>(&here);
+	std::uintptr_t size = static_cast<std::uintptr_t>(stack_depth) * sizeof(std::uint32_t);
+	const std::uint32_t* low = nullptr;
+	const std::uint32_t* high = nullptr;
+	if (size > ENTRY_ALLOWANCE + FRAME_GUARD) {
+		auto* first = reinterpret_cast<std::uint32_t*>((sp + ENTRY_ALLOWANCE - size + 3) & ~std::uintptr_t{3});
+		auto* end = reinterpret_cast<std::uint32_t*>(sp - FRAME_GUARD);
+		for (volatile std::uint32_t* word = first; word < end; word++) *word = PAINT;
+		low = first;
+		high = end;
+	}
+
+	Slot& slot = slots[id];
+	slot.used = true;
+	slot.handle = pros::c::task_get_current();
+	std::strncpy(slot.task_name, pros::c::task_get_name(slot.handle), sizeof(slot.task_name) - 1);
+	slot.task_name[sizeof(slot.task_name) - 1] = '\0';
+	slot.name = name;
+	slot.stack_size = size;
+	slot.paint_low = low;
+	slot.paint_high = high;
+	slot.woke_us = static_cast<std::uint32_t>(pros::micros());
+	slot.awake_us = 0;
+	slot.wakes = 0;
+	if (id == count) slot_count.store(count + 1);
+	return id;
+}
+
+static void sleeping(int id) {
+	if (id < 0) return;
+	slots[id].awake_us += static_cast<std::uint32_t>(pros::micros()) - slots[id].woke_us;
+}
+
+static void woke(int id) {
+	if (id < 0) return;
+	slots[id].woke_us = static_cast<std::uint32_t>(pros::micros());
+	slots[id].wakes++;
+}
+
+void delay_until(int id, std::uint32_t* prev_time, std::uint32_t delta) {
+	sleeping(id);
+	pros::Task::delay_until(prev_time, delta);
+	woke(id);
+}
+
+void delay(int id, std::uint32_t ms) {
+	sleeping(id);
+	pros::delay(ms);
+	woke(id);
+}
+
+static std::uint32_t stack_free(const Slot& slot) {
+	if (slot.paint_low == nullptr) return slot.stack_size;  // not painted, nothing known
+	const volatile std::uint32_t* word = slot.paint_low;
+	while (word < slot.paint_high && *word == PAINT) word++;
+	return static_cast<std::uint32_t>(word - slot.paint_low) * sizeof(std::uint32_t);
+}
+
+static const char* state_name(std::uint32_t state) {
+	switch (state) {
+		case pros::E_TASK_STATE_RUNNING: return "run";
+		case pros::E_TASK_STATE_READY: return "ready";
+		case pros::E_TASK_STATE_BLOCKED: return "block";
+		case pros::E_TASK_STATE_SUSPENDED: return "susp";
+		case pros::E_TASK_STATE_DELETED: return "dead";
+		default: return "?";
+	}
+}
+
+static void report_task() {
+	int monitor_id = add("Task Monitor");
+	std::uint32_t now = pros::millis();
+	std::uint32_t last_us = static_cast<std::uint32_t>(pros::micros());
+
+	while (true) {
+		delay_until(monitor_id, &now, REPORT_MS);
+		std::uint32_t now_us = static_cast<std::uint32_t>(pros::micros());
+		float elapsed_us = static_cast<float>(now_us - last_us);
+		last_us = now_us;
+
+		int count = slot_count.load();
+		int tightest = -1;
+		float tightest_fraction = 2;
+		Stats stats[MAX_TASKS];
+		std::unique_lock<pros::Mutex> slots_lock(add_mutex);  // a task re-registering moves its slot
+		for (int i = 0; i < count; i++) {
+			Slot& slot = slots[i];
+			stats[i] = {};
+			if (!slot.used) continue;
+			// A deleted task's handle points at freed memory, so it is never
+			// passed to the RTOS. Look the task up by name instead; if that
+			// no longer finds this handle the task is gone and its slot is
+			// freed for the next add(). A task deleted but not yet cleaned up
+			// is still found, and stays valid below: only the idle task frees
+			// it, and that can't run while this higher priority task is ready.
+			if (pros::c::task_get_by_name(slot.task_name) != slot.handle) {
+				slot.used = false;
+				continue;
+			}
+			pros::Task task(slot.handle);
+			stats[i].name = slot.name;
+			stats[i].state = task.get_state();
+			stats[i].priority = task.get_priority();
+			stats[i].cpu_percent = slot.awake_us.exchange(0) / elapsed_us * 100;
+			stats[i].wakes = slot.wakes.exchange(0);
+			stats[i].stack_free = stack_free(slot);
+			stats[i].stack_size = slot.stack_size;
+
+			float fraction = static_cast<float>(stats[i].stack_free) / stats[i].stack_size;
+			if (fraction < tightest_fraction) {
+				tightest = i;
+				tightest_fraction = fraction;
+			}
+		}
+		slots_lock.unlock();
+		{
+			std::lock_guard<pros::Mutex> lock(report_mutex);
+			for (int i = 0; i < count; i++) reports[i] = stats[i];
+		}
+
+		if (serial) {
+			std::printf("%-14s %4s %5s %6s %6s %11s  (%lu tasks total)\n", "task", "prio", "state", "cpu%", "wake/s",
+			            "stack free", static_cast<unsigned long>(pros::Task::get_count()));
+			for (int i = 0; i < count; i++) {
+				if (stats[i].name == nullptr) continue;
+				std::printf("%-14s %4lu %5s %6.1f %6lu %5lu/%5lu\n", stats[i].name,
+				            static_cast<unsigned long>(stats[i].priority), state_name(stats[i].state),
+				            static_cast<double>(stats[i].cpu_percent), static_cast<unsigned long>(stats[i].wakes),
+				            static_cast<unsigned long>(stats[i].stack_free),
+				            static_cast<unsigned long>(stats[i].stack_size));
+			}
+		}
+		if (tightest >= 0) {
+			pros::lcd::print(3, "%s: %.0f%% cpu, %luB stack free", stats[tightest].name,
+			                 static_cast<double>(stats[tightest].cpu_percent),
+			                 static_cast<unsigned long>(stats[tightest].stack_free));
+		}
+	}
+}
+
+void start() { pros::Task task(report_task, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "Task Monitor"); }
+
+void set_serial(bool enabled) { serial = enabled; }
+
+bool get(int id, Stats& stats) {
+	if (id < 0 || id >= slot_count.load()) return false;
+	std::lock_guard<pros::Mutex> lock(report_mutex);
+	stats = reports[id];
+	return stats.name != nullptr;
+}
+
+}  // namespace task_monitor
@@ -0,0 +1,154 @@
+#include "robotcore/tune.hpp"
+#include "robotcore/task_monitor.hpp"
+#include "main.h"
+#include "pros/apix.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <unistd.h>
+
+namespace tune {
+
+constexpr const char* SAVE_FILE = "/usd/tune.txt";
+constexpr std::uint32_t LOOP_MS = 20;
+// A control loop may still be reading the old front copy for one tick after a
+// swap, so the console never reuses it sooner than this.
+constexpr std::uint32_t MIN_SWAP_MS = 2 * LOOP_MS;
+
+struct Entry {
+	const char* name;
+	double Params::*field;
+	double min;
+	double max;
+};
+
+static const Entry entries[] = {
+	{"throttle_slew", &Params::throttle_slew, 1, 127},
+	{"turn_deadband", &Params::turn_deadband, 0, 127},
+	{"turn_divisor", &Params::turn_divisor, 1, 10},
+	{"store_roller_speed", &Params::store_roller_speed, -127, 127},
+};
+
+static Params buffers[2];
+static std::atomic<Params*> front{&buffers[0]};
+static std::uint32_t last_swap = 0;
+static pros::Mutex writer_mutex;  // writers queue up, readers never take it
+
+static const Entry* find(const char* name) {
+	for (const Entry& entry : entries) {
+		if (std::strcmp(entry.name, name) == 0) return &entry;
+	}
+	return nullptr;
+}
+
+// Callers hold writer_mutex.
+static void publish(const Params& next) {
+	std::uint32_t since = pros::millis() - last_swap;
+	if (since < MIN_SWAP_MS) pros::delay(MIN_SWAP_MS - since);
+	Params* back = front.load() == &buffers[0] ? &buffers[1] : &buffers[0];
+	*back = next;
+	front.store(back);
+	last_swap = pros::millis();
+}
+
+const Params& current() { return *front.load(); }
+
+bool set(const char* name, double value) {
+	const Entry* entry = find(name);
+	if (entry == nullptr || value < entry->min || value > entry->max) return false;
+	std::lock_guard<pros::Mutex> lock(writer_mutex);
+	Params next = current();
+	next.*(entry->field) = value;
+	publish(next);
+	return true;
+}
+
+static void print(const Entry& entry) { std::printf("%s = %g\n", entry.name, current().*(entry.field)); }
+
+static bool save() {
+	if (!pros::usd::is_installed()) return false;
+	FILE* file = std::fopen(SAVE_FILE, "w");
+	if (file == nullptr) return false;
+	std::setvbuf(file, nullptr, _IONBF, 0);  // no heap buffer, it's a few lines
+	for (const Entry& entry : entries) std::fprintf(file, "%s %g\n", entry.name, current().*(entry.field));
+	std::fclose(file);
+	return true;
+}
+
+static bool load() {
+	if (!pros::usd::is_installed()) return false;
+	FILE* file = std::fopen(SAVE_FILE, "r");
+	if (file == nullptr) return false;
+	std::setvbuf(file, nullptr, _IONBF, 0);
+	std::lock_guard<pros::Mutex> lock(writer_mutex);
+	Params next = current();
+	char name[32];
+	double value;
+	while (std::fscanf(file, "%31s %lf", name, &value) == 2) {
+		const Entry* entry = find(name);
+		if (entry != nullptr && value >= entry->min && value <= entry->max) next.*(entry->field) = value;
+	}
+	std::fclose(file);
+	publish(next);
+	return true;
+}
+
+static void run_command(char* line) {
+	char* command = std::strtok(line, " \t");
+	if (command == nullptr) return;
+	char* name = std::strtok(nullptr, " \t");
+	char* value = std::strtok(nullptr, " \t");
+
+	if (std::strcmp(command, "list") == 0) {
+		for (const Entry& entry : entries) print(entry);
+	} else if (std::strcmp(command, "get") == 0 && name != nullptr) {
+		const Entry* entry = find(name);
+		if (entry != nullptr) print(*entry);
+		else std::printf("no parameter %s\n", name);
+	} else if (std::strcmp(command, "set") == 0 && name != nullptr && value != nullptr) {
+		if (set(name, std::strtod(value, nullptr))) print(*find(name));
+		else std::printf("can't set %s to %s\n", name, value);
+	} else if (std::strcmp(command, "save") == 0) {
+		std::printf(save() ? "saved to %s\n" : "couldn't write %s\n", SAVE_FILE);
+	} else if (std::strcmp(command, "load") == 0) {
+		std::printf(load() ? "loaded %s\n" : "couldn't read %s\n", SAVE_FILE);
+	} else {
+		std::printf("commands: list, get <name>, set <name> <value>, save, load\n");
+	}
+}
+
+static void console_task() {
+	int monitor_id = task_monitor::add("Tune Console");
+	char line[64];
+	std::size_t len = 0;
+	std::uint32_t now = pros::millis();
+
+	while (true) {
+		// Only read what has already arrived so the task never sits in read().
+		std::int32_t available = pros::c::fdctl(STDIN_FILENO, DEVCTL_FIONREAD, nullptr);
+		if (available == PROS_ERR) available = 0;
+		while (available-- > 0) {
+			char c;
+			if (read(STDIN_FILENO, &c, 1) != 1) break;
+			if (c == '\r' || c == '\n') {
+				line[len] = '\0';
+				run_command(line);
+				len = 0;
+			} else if (len < sizeof(line) - 1) {
+				line[len++] = c;
+			}
+		}
+		task_monitor::delay_until(monitor_id, &now, LOOP_MS);
+	}
+}
+
+void start() {
+	// Don't let printf stall the console when nobody is listening on USB.
+	pros::c::fdctl(STDOUT_FILENO, SERCTL_NOBLKWRITE, nullptr);
+	load();
+	pros::Task task(console_task, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "Tune Console");
+}
+
+}  // namespace tune
@@ -0,0 +1,198 @@
+/**
+ * \file blend_check.cpp
+ *
+ * Checks and times the ARGB8888 blend kernels in robotcore/blend_neon.h.
+ *
+ * Random fills and image blends (odd widths, padded rows, the alphas where
+ * LVGL's rounding changes: 0-3, 128, 252-255) are drawn three ways: by
+ * LVGL's own C code, by the reference loops and, when built for NEON, by the
+ * NEON kernels. The destination buffers, padding included, have to match
+ * byte for byte. Then it times each on dashboard-sized work: a chart
+ * background, a translucent bar and a chart-sized image.
+ *
+ * Not part of the robot build. It needs an LVGL built WITHOUT
+ * ROBOTCORE_NEON_BLEND, so the LVGL side really is LVGL's C code; the
+ * liblvgl_host.a from tools/lvgl_bench.cpp is one. From the project
+ * directory, on the computer (the NEON side reports "not built for NEON"):
+ *
+ *   g++ -std=gnu++20 -O2 -iquote include -I include -DLV_CONF_PATH=$PWD/tools/lvgl_bench_conf.h \
+ *       tools/blend_check.cpp src/robotcore/blend_neon.cpp build/lvgl_host/liblvgl_host.a -lm -o blend_check
+ *
+ * and for the NEON kernels, on any Cortex-A board with the same liblvgl
+ * built by arm-linux-gnueabihf-gcc:
+ *
+ *   arm-linux-gnueabihf-g++ -std=gnu++20 -O2 -mcpu=cortex-a9 -mfpu=neon-fp16 -mfloat-abi=hard ... (same files)
+ */
+
+#include "liblvgl/draw/sw/blend/lv_draw_sw_blend_to_argb8888.h"
+#include "robotcore/blend_neon.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+constexpr int CASES = 20000;
+constexpr int TIMING_REPEATS = 2000;
+constexpr std::uint8_t EDGE_ALPHAS[] = {0, 1, 2, 3, 128, 252, 253, 254, 255};
+
+enum class Kind { fill, image };
+
+struct Case {
+	Kind kind;
+	std::int32_t w;
+	std::int32_t h;
+	std::int32_t dest_stride;
+	std::int32_t src_stride;
+	lv_color_t color;
+	lv_opa_t opa;
+	std::vector<std::uint8_t> dest;
+	std::vector<std::uint8_t> src;
+};
+
+enum class Blender { lvgl, reference, neon };
+
+static const char* NAMES[] = {"lvgl", "reference", "neon"};
+
+static std::mt19937 rng(1248);
+
+static std::uint8_t random_alpha() {
+	if (rng() % 2) return EDGE_ALPHAS[rng() % sizeof(EDGE_ALPHAS)];
+	return rng() % 256;
+}
+
+static void randomize(std::vector<std::uint8_t>& buf) {
+	for (std::size_t i = 0; i < buf.size(); i++) buf[i] = i % 4 == 3 ? random_alpha() : rng() % 256;
+}
+
+static Case make(Kind kind, std::int32_t w, std::int32_t h, std::int32_t padding, lv_opa_t opa) {
+	Case c;
+	c.kind = kind;
+	c.w = w;
+	c.h = h;
+	c.dest_stride = (w + padding) * 4;
+	c.src_stride = (w + (padding ? rng() % 3 : 0)) * 4;
+	c.color.red = rng() % 256;
+	c.color.green = rng() % 256;
+	c.color.blue = rng() % 256;
+	c.opa = opa;
+	c.dest.resize(c.dest_stride * h);
+	randomize(c.dest);
+	if (kind == Kind::image) {
+		c.src.resize(c.src_stride * h);
+		randomize(c.src);
+	}
+	return c;
+}
+
+// Draws c into dest the way lv_draw_sw_blend_*_to_argb8888() would pick a
+// kernel. False if the blender isn't available in this build.
+static bool blend(Blender blender, const Case& c, std::uint8_t* dest) {
+	bool opaque = c.opa >= LV_OPA_MAX;
+	if (c.kind == Kind::fill) {
+		lv_draw_sw_blend_fill_dsc_t dsc = {};
+		dsc.dest_buf = dest;
+		dsc.dest_w = c.w;
+		dsc.dest_h = c.h;
+		dsc.dest_stride = c.dest_stride;
+		dsc.color = c.color;
+		dsc.opa = c.opa;
+		switch (blender) {
+			case Blender::lvgl: lv_draw_sw_blend_color_to_argb8888(&dsc); return true;
+			case Blender::reference:
+				if (opaque) {
+					blend_reference_color_to_argb8888(&dsc);
+				} else {
+					blend_reference_color_to_argb8888_with_opa(&dsc);
+				}
+				return true;
+			case Blender::neon:
+				return (opaque ? blend_neon_color_to_argb8888(&dsc) : blend_neon_color_to_argb8888_with_opa(&dsc)) ==
+				       LV_RESULT_OK;
+		}
+	}
+	lv_draw_sw_blend_image_dsc_t dsc = {};
+	dsc.dest_buf = dest;
+	dsc.dest_w = c.w;
+	dsc.dest_h = c.h;
+	dsc.dest_stride = c.dest_stride;
+	dsc.src_buf = c.src.data();
+	dsc.src_stride = c.src_stride;
+	dsc.src_color_format = LV_COLOR_FORMAT_ARGB8888;
+	dsc.opa = c.opa;
+	dsc.blend_mode = LV_BLEND_MODE_NORMAL;
+	switch (blender) {
+		case Blender::lvgl: lv_draw_sw_blend_image_to_argb8888(&dsc); return true;
+		case Blender::reference:
+			if (opaque) {
+				blend_reference_argb8888_to_argb8888(&dsc);
+			} else {
+				blend_reference_argb8888_to_argb8888_with_opa(&dsc);
+			}
+			return true;
+		case Blender::neon:
+			return (opaque ? blend_neon_argb8888_to_argb8888(&dsc) : blend_neon_argb8888_to_argb8888_with_opa(&dsc)) ==
+			       LV_RESULT_OK;
+	}
+	return false;
+}
+
+// Returns false if any blender disagreed with LVGL.
+static bool check() {
+	int mismatches[3] = {};
+	bool have_neon = true;
+	for (int i = 0; i < CASES; i++) {
+		Kind kind = i % 2 ? Kind::image : Kind::fill;
+		Case c = make(kind, 1 + rng() % 67, 1 + rng() % 4, rng() % 3, random_alpha());
+		std::vector<std::uint8_t> expected = c.dest;
+		blend(Blender::lvgl, c, expected.data());
+		for (Blender blender : {Blender::reference, Blender::neon}) {
+			std::vector<std::uint8_t> out = c.dest;
+			if (!blend(blender, c, out.data())) {
+				have_neon = false;
+				continue;
+			}
+			if (std::memcmp(out.data(), expected.data(), out.size()) == 0) continue;
+			if (mismatches[static_cast<int>(blender)]++ < 5) {
+				std::printf("%s differs: %s %dx%d stride %d opa %d\n", NAMES[static_cast<int>(blender)],
+				            kind == Kind::fill ? "fill" : "image", c.w, c.h, c.dest_stride, c.opa);
+			}
+		}
+	}
+	std::printf("reference: %d/%d cases differ from LVGL\n", mismatches[1], CASES);
+	if (have_neon) {
+		std::printf("neon:      %d/%d cases differ from LVGL\n", mismatches[2], CASES);
+	} else {
+		std::printf("neon:      not built for NEON\n");
+	}
+	return mismatches[1] == 0 && mismatches[2] == 0;
+}
+
+static void benchmark(const char* name, const Case& c) {
+	std::printf("%-22s", name);
+	for (Blender blender : {Blender::lvgl, Blender::reference, Blender::neon}) {
+		std::vector<std::uint8_t> out = c.dest;
+		if (!blend(blender, c, out.data())) continue;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < TIMING_REPEATS; i++) {
+			// Blending translucent pixels over and over drifts toward the
+			// color, so start from the same destination each time.
+			std::memcpy(out.data(), c.dest.data(), out.size());
+			blend(blender, c, out.data());
+		}
+		double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		std::printf("  %s %6.2f ns/px", NAMES[static_cast<int>(blender)], ns / TIMING_REPEATS / (c.w * c.h));
+	}
+	std::printf("\n");
+}
+
+int main() {
+	bool ok = check();
+	// Sizes from dashboard.cpp: a 300x110 chart, a 14x150 bar.
+	benchmark("fill 300x110", make(Kind::fill, 300, 110, 0, 255));
+	benchmark("fill 14x150 opa 128", make(Kind::fill, 14, 150, 0, 128));
+	benchmark("image 300x110", make(Kind::image, 300, 110, 0, 255));
+	benchmark("image 300x110 opa 128", make(Kind::image, 300, 110, 0, 128));
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+/**
+ * \file image_compiler.cpp
+ *
+ * Turns a PNG into a compressed LVGL image for image_assets.
+ *
+ * The output is LVGL 9's binary image format: an lv_image_header_t, then
+ * for a compressed image an image_assets::CompressedHeader and the
+ * compressed pixels. Images with any transparency are stored as ARGB8888,
+ * opaque ones as RGB565 at half the size (--argb8888 keeps them 32-bit).
+ * Both LVGL's RLE and LZ4 are tried and the smaller one is written, unless
+ * --rle, --lz4 or --none picks one. Every file is decompressed again with
+ * image_assets::decompress() and checked before it is written.
+ *
+ * Not part of the robot build. PNGs are read with the lodepng in LVGL, so
+ * this links the liblvgl_host.a from tools/lvgl_bench.cpp. From the project
+ * directory:
+ *
+ *   g++ -std=gnu++20 -O2 -iquote include -I include -DLV_CONF_PATH=$PWD/tools/lvgl_bench_conf.h \
+ *       tools/image_compiler.cpp src/robotcore/image_assets.cpp build/lvgl_host/liblvgl_host.a -lm \
+ *       -o image_compiler
+ *   ./image_compiler [--rle | --lz4 | --none] [--argb8888] logo.png logo.bin
+ *
+ * then copy logo.bin to the SD card and show it with
+ * image_assets::create(parent, "S:logo.bin").
+ */
+
+#define LODEPNG_NO_COMPILE_CPP  // its C++ API would be declared inside extern "C"
+#include "liblvgl/libs/lodepng/lodepng.h"
+#include "robotcore/image_assets.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using Bytes = std::vector<std::uint8_t>;
+
+constexpr int LZ4_MIN_MATCH = 4;
+constexpr int LZ4_HASH_BITS = 16;
+constexpr std::uint32_t LZ4_MAX_OFFSET = 65535;
+constexpr std::uint32_t LZ4_LAST_LITERALS = 5;   // the block format's end rules
+constexpr std::uint32_t LZ4_MATCH_LIMIT = 12;
+
+static bool read_file(const char* path, Bytes& out) {
+	std::FILE* file = std::fopen(path, "rb");
+	if (file == nullptr) return false;
+	std::uint8_t chunk[4096];
+	std::size_t read;
+	while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) out.insert(out.end(), chunk, chunk + read);
+	std::fclose(file);
+	return true;
+}
+
+// LVGL's RLE: runs of 2 or more equal pixels as a count and one pixel, the
+// rest as a count and the pixels as is. Counts go up to 127.
+static Bytes rle_compress(const Bytes& in, std::size_t pixel_size) {
+	Bytes out;
+	std::size_t pixels = in.size() / pixel_size;
+	auto same = [&](std::size_t a, std::size_t b) {
+		return std::memcmp(&in[a * pixel_size], &in[b * pixel_size], pixel_size) == 0;
+	};
+	std::size_t i = 0;
+	while (i < pixels) {
+		std::size_t run = 1;
+		while (i + run < pixels && run < 127 && same(i, i + run)) run++;
+		if (run >= 2) {
+			out.push_back(static_cast<std::uint8_t>(run));
+			out.insert(out.end(), &in[i * pixel_size], &in[(i + 1) * pixel_size]);
+			i += run;
+			continue;
+		}
+		std::size_t literals = 1;
+		while (i + literals < pixels && literals < 127 &&
+		       !(i + literals + 1 < pixels && same(i + literals, i + literals + 1))) {
+			literals++;
+		}
+		out.push_back(static_cast<std::uint8_t>(0x80 | literals));
+		out.insert(out.end(), &in[i * pixel_size], &in[(i + literals) * pixel_size]);
+		i += literals;
+	}
+	return out;
+}
+
+static void lz4_length(Bytes& out, std::size_t length) {
+	for (; length >= 255; length -= 255) out.push_back(255);
+	out.push_back(static_cast<std::uint8_t>(length));
+}
+
+static void lz4_sequence(Bytes& out, const std::uint8_t* literals, std::size_t literal_count, std::size_t offset,
+                         std::size_t match_length) {
+	std::size_t match_code = match_length > 0 ? match_length - LZ4_MIN_MATCH : 0;
+	out.push_back(static_cast<std::uint8_t>((literal_count < 15 ? literal_count : 15) << 4 |
+	                                        (match_code < 15 ? match_code : 15)));
+	if (literal_count >= 15) lz4_length(out, literal_count - 15);
+	out.insert(out.end(), literals, literals + literal_count);
+	if (match_length == 0) return;
+	out.push_back(static_cast<std::uint8_t>(offset));
+	out.push_back(static_cast<std::uint8_t>(offset >> 8));
+	if (match_code >= 15) lz4_length(out, match_code - 15);
+}
+
+// A greedy LZ4 block compressor: each position's 4 bytes are hashed, and the
+// last position with the same hash is the match candidate.
+static Bytes lz4_compress(const Bytes& in) {
+	Bytes out;
+	std::vector<std::int64_t> last(1 << LZ4_HASH_BITS, -1);
+	auto hash = [&](std::size_t i) {
+		std::uint32_t word;
+		std::memcpy(&word, &in[i], sizeof(word));
+		return (word * 2654435761u) >> (32 - LZ4_HASH_BITS);
+	};
+	std::size_t anchor = 0;
+	std::size_t i = 0;
+	std::size_t match_end_limit = in.size() > LZ4_LAST_LITERALS ? in.size() - LZ4_LAST_LITERALS : 0;
+	while (in.size() >= LZ4_MATCH_LIMIT && i + LZ4_MATCH_LIMIT <= in.size()) {
+		std::uint32_t h = hash(i);
+		std::int64_t candidate = last[h];
+		last[h] = static_cast<std::int64_t>(i);
+		if (candidate < 0 || i - candidate > LZ4_MAX_OFFSET ||
+		    std::memcmp(&in[candidate], &in[i], LZ4_MIN_MATCH) != 0) {
+			i++;
+			continue;
+		}
+		std::size_t length = LZ4_MIN_MATCH;
+		while (i + length < match_end_limit && in[candidate + length] == in[i + length]) length++;
+		lz4_sequence(out, &in[anchor], i - anchor, i - candidate, length);
+		i += length;
+		anchor = i;
+	}
+	lz4_sequence(out, in.data() + anchor, in.size() - anchor, 0, 0);
+	return out;
+}
+
+int main(int argc, char** argv) {
+	int method = -1;  // smaller of RLE and LZ4
+	bool keep_argb = false;
+	const char* paths[2] = {nullptr, nullptr};
+	int path_count = 0;
+	for (int i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "--rle") == 0) {
+			method = LV_IMAGE_COMPRESS_RLE;
+		} else if (std::strcmp(argv[i], "--lz4") == 0) {
+			method = LV_IMAGE_COMPRESS_LZ4;
+		} else if (std::strcmp(argv[i], "--none") == 0) {
+			method = LV_IMAGE_COMPRESS_NONE;
+		} else if (std::strcmp(argv[i], "--argb8888") == 0) {
+			keep_argb = true;
+		} else if (path_count < 2) {
+			paths[path_count++] = argv[i];
+		}
+	}
+	if (path_count != 2) {
+		std::fprintf(stderr, "usage: %s [--rle | --lz4 | --none] [--argb8888] in.png out.bin\n", argv[0]);
+		return 2;
+	}
+
+	Bytes png;
+	if (!read_file(paths[0], png)) {
+		std::perror(paths[0]);
+		return 1;
+	}
+	lv_init();  // lodepng allocates through lv_malloc
+	unsigned char* rgba = nullptr;
+	unsigned w = 0, h = 0;
+	unsigned error = lodepng_decode32(&rgba, &w, &h, png.data(), png.size());
+	if (error != 0) {
+		std::fprintf(stderr, "%s: %s\n", paths[0], lodepng_error_text(error));
+		return 1;
+	}
+
+	bool opaque = true;
+	for (std::size_t i = 0; i < std::size_t(w) * h; i++) opaque &= rgba[i * 4 + 3] == 255;
+	lv_color_format_t format = opaque && !keep_argb ? LV_COLOR_FORMAT_RGB565 : LV_COLOR_FORMAT_ARGB8888;
+	std::size_t pixel_size = lv_color_format_get_size(format);
+	Bytes pixels(std::size_t(w) * h * pixel_size);
+	for (std::size_t i = 0; i < std::size_t(w) * h; i++) {
+		const unsigned char* p = &rgba[i * 4];
+		if (format == LV_COLOR_FORMAT_RGB565) {
+			std::uint16_t value = (p[0] & 0xF8) << 8 | (p[1] & 0xFC) << 3 | p[2] >> 3;
+			std::memcpy(&pixels[i * 2], &value, 2);
+		} else {
+			std::uint8_t bgra[4] = {p[2], p[1], p[0], p[3]};
+			std::memcpy(&pixels[i * 4], bgra, 4);
+		}
+	}
+	lv_free(rgba);
+
+	Bytes packed = pixels;
+	if (method != LV_IMAGE_COMPRESS_NONE) {
+		Bytes rle = rle_compress(pixels, pixel_size);
+		Bytes lz4 = lz4_compress(pixels);
+		if (method == -1) method = rle.size() <= lz4.size() ? LV_IMAGE_COMPRESS_RLE : LV_IMAGE_COMPRESS_LZ4;
+		packed = method == LV_IMAGE_COMPRESS_RLE ? rle : lz4;
+	}
+
+	Bytes check(pixels.size());
+	if (!image_assets::decompress(static_cast<lv_image_compress_t>(method), packed.data(), packed.size(),
+	                              check.data(), check.size(), pixel_size) ||
+	    check != pixels) {
+		std::fprintf(stderr, "%s: compressed data doesn't decompress to the image\n", paths[0]);
+		return 1;
+	}
+
+	lv_image_header_t header = {};
+	header.magic = LV_IMAGE_HEADER_MAGIC;
+	header.cf = format;
+	header.flags = method != LV_IMAGE_COMPRESS_NONE ? LV_IMAGE_FLAGS_COMPRESSED : 0;
+	header.w = w;
+	header.h = h;
+	header.stride = w * pixel_size;
+	std::FILE* file = std::fopen(paths[1], "wb");
+	if (file == nullptr) {
+		std::perror(paths[1]);
+		return 1;
+	}
+	std::fwrite(&header, sizeof(header), 1, file);
+	if (method != LV_IMAGE_COMPRESS_NONE) {
+		image_assets::CompressedHeader compressed = {static_cast<std::uint32_t>(method),
+		                                             static_cast<std::uint32_t>(packed.size()),
+		                                             static_cast<std::uint32_t>(pixels.size())};
+		std::fwrite(&compressed, sizeof(compressed), 1, file);
+	}
+	std::fwrite(packed.data(), 1, packed.size(), file);
+	std::fclose(file);
+
+	static const char* const METHODS[] = {"uncompressed", "RLE", "LZ4"};
+	std::printf("%s: %ux%u %s, %zu bytes %s (%.0f%% of %zu)\n", paths[1], w, h,
+	            format == LV_COLOR_FORMAT_RGB565 ? "RGB565" : "ARGB8888", packed.size(), METHODS[method],
+	            100.0 * packed.size() / pixels.size(), pixels.size());
+	return 0;
+}
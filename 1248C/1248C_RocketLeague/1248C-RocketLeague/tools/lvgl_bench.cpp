@@ -0,0 +1,619 @@
+/**
+ * \file lvgl_bench.cpp
+ *
+ * Computer benchmark for what the brain screen costs to draw.
+ *
+ * LVGL runs here with the robot's lv_conf.h (see tools/lvgl_bench_conf.h)
+ * and a display that flushes into a framebuffer in memory instead of the
+ * kernel's screen driver. Each scenario builds one of our screens, then
+ * plays back what the robot code does to it frame by frame, one frame per
+ * LV_DEF_REFR_PERIOD of robot time (LVGL 9 reads that one, not the older
+ * LV_DISP_DEF_REFR_PERIOD that lv_conf.h still sets):
+ *
+ * - llemu: the LLEMU text screen with main.cpp publishing the button states
+ *   every loop, shown on line 0 through bindings, and the task monitor and
+ *   motor health lines changing now and then.
+ * - dashboard: the telemetry screen from dashboard.cpp, with its timer
+ *   adding 20 samples (200 Hz) to each stream chart every 100 ms.
+ * - dashboard_lv_chart: the same with the lv_chart shift-mode charts the
+ *   dashboard had before stream_chart, for comparison.
+ * - selector: a button matrix of autonomous routines with the highlighted
+ *   choice moving every half second.
+ *
+ * Frames are rendered back to back with lv_refr_now(), so the frame rate
+ * reported is how fast this computer could draw them, not the 25 Hz the
+ * robot runs at. Per scenario it prints the frame times, the draw tasks and
+ * pixels each frame produced, what lv_sysmon measured, and a checksum of the
+ * final framebuffer so a renderer change can be checked for identical output.
+ *
+ * Built with -DLVGL_BENCH_ROBOT_TIMERS (LVGL and the bench both), LVGL keeps
+ * the robot's LV_USE_PERF_MONITOR 0 and frames go through lv_timer_handler()
+ * on a robot clock that moves FRAME_MS per frame, the way the LVGL task runs
+ * them on the brain. LVGL pauses its refresh timer once a frame is drawn and
+ * only an invalidation starts it again, so a frame may draw nothing. After
+ * the scenario it runs IDLE_MS more with nothing changing; the bench fails
+ * if screen_budget still has areas waiting then. There is no lv_sysmon line
+ * in this build.
+ * With --trace, the lv_profiler_builtin trace of every frame is written to
+ * a file that Perfetto (ui.perfetto.dev) opens. With --budget, frames go
+ * through screen_budget with that many pixels per frame, and the dashboard
+ * charts are low priority like on the robot. With --glyph-cache, labels
+ * draw through glyph_cache; the checksums should not change. With --rgb565,
+ * each scenario runs three times: in 32-bit color as on the robot, then in
+ * RGB565 with the flush from screen_rgb565 both plain and dithered, and the
+ * 16-bit runs also report how far their final frame is from the 32-bit one.
+ * With --heap, the scenarios' screens are kept until the end like the
+ * robot keeps its screens, and lvgl_heap reports LVGL's heap afterwards: the
+ * bench fails if the peak went over lvgl_heap::UI_HEAP_BUDGET or an
+ * allocation failed. --no-small-pool runs it with lvgl_heap's small block
+ * pool off, for comparison.
+ *
+ * The screen is 480x240: the panel is 480x272 but VEXos keeps the top 32 rows
+ * and LVGL gets the rest (LV_HOR_RES_MAX, LV_VER_RES_MAX).
+ *
+ * Not part of the robot build. Only LVGL's headers are in this project, so
+ * the C sources come from the same LVGL 9.2 release the headers do
+ * (PROS's liblvgl package). From the project directory, with LVGL_SRC
+ * pointing at them:
+ *
+ *   mkdir -p build/lvgl_host && cd build/lvgl_host && \
+ *       gcc -O2 -c -I ../../include -DLV_CONF_PATH=$PWD/../../tools/lvgl_bench_conf.h \
+ *       $(find $LVGL_SRC -name '*.c') && ar rcs liblvgl_host.a *.o && cd ../..
+ *   g++ -std=gnu++20 -O2 -iquote include -I include -DLV_CONF_PATH=$PWD/tools/lvgl_bench_conf.h \
+ *       tools/lvgl_bench.cpp src/robotcore/screen_budget.cpp src/robotcore/glyph_cache.cpp \
+ *       src/robotcore/screen_rgb565.cpp src/robotcore/stream_chart.cpp src/robotcore/bindings.cpp \
+ *       -DROBOTCORE_LVGL_SMALL_POOL src/robotcore/lvgl_heap.cpp \
+ *       -Wl,--wrap=lv_malloc,--wrap=lv_malloc_zeroed,--wrap=lv_realloc,--wrap=lv_free \
+ *       build/lvgl_host/liblvgl_host.a -lm -o lvgl_bench
+ *   ./lvgl_bench [--trace lvgl_trace.txt] [--budget pixels] [--glyph-cache] [--rgb565]
+ *                [--heap [--no-small-pool]] [scenario...]
+ *
+ * To check a smaller LVGL heap, add -DLV_MEM_SIZE=<bytes> to both builds, and
+ * for the robot's timers -DLVGL_BENCH_ROBOT_TIMERS, in a build/lvgl_host_timers
+ * of its own.
+ *
+ * To bench the NEON blend kernels (robotcore/blend_neon.h) on a Cortex-A
+ * board, build a second LVGL into build/lvgl_host_neon with
+ * -DROBOTCORE_NEON_BLEND -iquote ../../include added, and link it with
+ * src/robotcore/blend_neon.cpp added. The checksums should match the plain
+ * build's.
+ */
+
+#include "liblvgl/lvgl.h"
+#include "robotcore/bindings.hpp"
+#include "robotcore/glyph_cache.hpp"
+#include "robotcore/lvgl_heap.hpp"
+#include "robotcore/screen_budget.hpp"
+#include "robotcore/screen_rgb565.hpp"
+#include "robotcore/stream_chart.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+constexpr int WIDTH = 480;
+constexpr int HEIGHT = 240;
+constexpr int DRAW_BUF_LINES = 40;              // partial rendering, a sixth of the screen per pass
+constexpr int FRAME_MS = LV_DEF_REFR_PERIOD;
+constexpr int FRAMES = 10000 / FRAME_MS;        // 10 s of robot time
+constexpr int IDLE_MS = 1000;                   // robot timers: quiet time after a scenario
+
+#ifdef LVGL_BENCH_ROBOT_TIMERS
+constexpr bool ROBOT_TIMERS = true;
+#else
+constexpr bool ROBOT_TIMERS = false;
+#endif
+
+static lv_display_t* display;
+alignas(64) static std::uint8_t draw_buf[WIDTH * DRAW_BUF_LINES * 4];
+alignas(64) static std::uint8_t framebuffer[WIDTH * HEIGHT * 4];  // XRGB8888 like the V5 screen
+alignas(64) static std::uint8_t reference[WIDTH * HEIGHT * 4];    // last 32-bit frame, for --rgb565
+static std::FILE* trace_file = nullptr;
+static std::uint32_t pixel_budget = 0;  // 0: screen_budget off
+static bool use_glyph_cache = false;
+static bool check_heap = false;
+static std::vector<lv_obj_t*> kept_screens;  // --heap
+static std::uint32_t robot_ms = 0;           // LVGL's clock with robot timers
+static bool idle_ok = true;
+
+struct Profile {
+	const char* suffix;
+	lv_color_format_t format;
+	bool dither;
+};
+
+static const Profile PROFILES[] = {
+    {"", LV_COLOR_FORMAT_ARGB8888, false},
+    {" 565", LV_COLOR_FORMAT_RGB565, false},
+    {" 565d", LV_COLOR_FORMAT_RGB565, true},
+};
+static int profile_count = 1;  // 3 with --rgb565
+static const Profile* profile = &PROFILES[0];
+
+// What one frame produced.
+struct FrameCounts {
+	std::uint32_t draw_tasks;
+	std::uint32_t flushes;
+	std::uint32_t pixels;
+};
+
+static FrameCounts counts;
+#if LV_USE_PERF_MONITOR
+static lv_sysmon_perf_info_t perf;
+#endif
+
+static const auto epoch = std::chrono::steady_clock::now();
+
+static std::uint32_t micros() {
+	return static_cast<std::uint32_t>(
+	    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count());
+}
+
+static std::uint32_t millis() { return ROBOT_TIMERS ? robot_ms : micros() / 1000; }
+
+static void flush(lv_display_t* disp, const lv_area_t* area, std::uint8_t* pixels) {
+	lv_color_format_t format = lv_display_get_color_format(disp);
+	std::uint32_t pixel_size = lv_color_format_get_size(format);
+	std::int32_t width = lv_area_get_width(area);
+	std::uint32_t stride = lv_draw_buf_width_to_stride(width, format);
+	if (format == LV_COLOR_FORMAT_RGB565) {
+		screen_rgb565::expand(pixels, stride, reinterpret_cast<std::uint32_t*>(framebuffer) + area->y1 * WIDTH + area->x1,
+		                      WIDTH, *area, profile->dither);
+	} else {
+		for (std::int32_t y = area->y1; y <= area->y2; y++) {
+			std::memcpy(&framebuffer[(y * WIDTH + area->x1) * pixel_size], pixels + (y - area->y1) * stride,
+			            width * pixel_size);
+		}
+	}
+	counts.flushes++;
+	counts.pixels += lv_area_get_size(area);
+	lv_display_flush_ready(disp);
+}
+
+static void on_draw_task(lv_event_t*) { counts.draw_tasks++; }
+
+static lv_obj_tree_walk_res_t watch(lv_obj_t* obj, void*) {
+	lv_obj_add_flag(obj, LV_OBJ_FLAG_SEND_DRAW_TASK_EVENTS);
+	lv_obj_add_event_cb(obj, on_draw_task, LV_EVENT_DRAW_TASK_ADDED, nullptr);
+	return LV_OBJ_TREE_WALK_NEXT;
+}
+
+#if LV_USE_PERF_MONITOR
+static void on_perf(lv_observer_t*, lv_subject_t* subject) {
+	perf = *static_cast<const lv_sysmon_perf_info_t*>(lv_subject_get_pointer(subject));
+}
+#endif
+
+static void write_trace(const char* text) {
+	if (trace_file != nullptr) std::fputs(text, trace_file);
+}
+
+// True on the frames where a period boundary of robot time passed.
+static bool every(int frame, int period_ms) {
+	return frame == 0 || frame * FRAME_MS / period_ms != (frame - 1) * FRAME_MS / period_ms;
+}
+
+// Draws one frame and returns how long it took in us. With robot timers,
+// robot time moves on a frame and LVGL runs whatever timers are due, which
+// draws nothing if its refresh timer is paused.
+static std::uint32_t draw_frame() {
+	counts = {};
+	std::uint32_t start = micros();
+	if (ROBOT_TIMERS) {
+		robot_ms += FRAME_MS;
+		lv_timer_handler();
+	} else {
+		lv_refr_now(display);
+	}
+	return micros() - start;
+}
+
+static std::uint32_t checksum() {
+	std::uint32_t hash = 2166136261u;  // FNV-1a
+	for (std::uint8_t byte : framebuffer) hash = (hash ^ byte) * 16777619u;
+	return hash;
+}
+
+// LLEMU: eight text lines over three buttons, like the PROS LLEMU screen.
+namespace llemu {
+
+static lv_obj_t* lines[8];
+static int buttons = -1;
+
+static void show_buttons(lv_obj_t* line, std::int32_t bits) {
+	lv_label_set_text_fmt(line, "%d %d %d", (bits & 4) >> 2, (bits & 2) >> 1, bits & 1);
+}
+
+static void build(lv_obj_t* screen) {
+	lv_obj_set_style_bg_color(screen, lv_color_hex(0x5abc03), 0);
+	for (int i = 0; i < 8; i++) {
+		lines[i] = lv_label_create(screen);
+		lv_obj_set_pos(lines[i], 10, 5 + i * 24);
+		lv_obj_set_width(lines[i], WIDTH - 20);
+		lv_label_set_long_mode(lines[i], LV_LABEL_LONG_CLIP);
+		lv_label_set_text(lines[i], "");
+	}
+	for (int i = 0; i < 3; i++) {
+		lv_obj_t* button = lv_button_create(screen);
+		lv_obj_set_pos(button, 10 + i * 157, HEIGHT - 42);
+		lv_obj_set_size(button, 145, 36);
+	}
+	lv_label_set_text(lines[1], "Rayed FTW");
+	if (buttons < 0) buttons = bindings::subject();
+	bindings::publish(buttons, 0);
+	bindings::sync();
+	bindings::bind(buttons, lines[0], show_buttons);
+}
+
+static void step(int frame) {
+	// opcontrol publishes the button states every loop; line 0 changes only when they do.
+	int seconds = frame * FRAME_MS / 1000;
+	bindings::publish(buttons, (seconds / 4 % 2) << 1);
+	bindings::sync();
+	if (every(frame, 1000)) {
+		lv_label_set_text_fmt(lines[3], "opcontrol: %d%% cpu, %dB stack free", 20 + seconds % 7, 1800 - seconds);
+	}
+	if (every(frame, 2000)) lv_label_set_text(lines[4], seconds / 2 % 2 ? "HOT: left 2 57C" : "");
+}
+
+}  // namespace llemu
+
+// Same layout as dashboard.cpp.
+namespace dashboard {
+
+constexpr int DRIVE_MOTORS = 6;
+constexpr int SAMPLES_PER_COLUMN = 2;
+constexpr int CHART_POINTS = 100;  // the lv_chart version
+constexpr int DRAW_PERIOD_MS = 100;
+constexpr int SAMPLE_MS = 5;
+
+static bool lv_charts = false;
+static lv_obj_t* current_chart;
+static lv_chart_series_t* left_current;
+static lv_chart_series_t* right_current;
+static lv_obj_t* jitter_chart;
+static lv_chart_series_t* jitter_series;
+static lv_obj_t* temp_bars[DRIVE_MOTORS + 2];
+static lv_obj_t* throughput_label;
+static lv_obj_t* jitter_label;
+static int samples = 0;
+
+static lv_obj_t* make_chart(lv_obj_t* screen, std::int32_t y, std::int32_t max) {
+	lv_obj_t* chart;
+	if (lv_charts) {
+		chart = lv_chart_create(screen);
+		lv_obj_set_size(chart, 300, 110);
+		lv_chart_set_type(chart, LV_CHART_TYPE_LINE);
+		lv_chart_set_update_mode(chart, LV_CHART_UPDATE_MODE_SHIFT);
+		lv_chart_set_point_count(chart, CHART_POINTS);
+		lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, 0, max);
+		lv_obj_set_style_size(chart, 0, 0, LV_PART_INDICATOR);
+	} else {
+		chart = stream_chart::create(screen, 300, 110, 0, max, SAMPLES_PER_COLUMN);
+	}
+	lv_obj_set_pos(chart, 5, y);
+	screen_budget::set_priority(chart, screen_budget::Priority::low);
+	return chart;
+}
+
+static lv_chart_series_t* add_series(lv_obj_t* chart, lv_palette_t palette) {
+	if (lv_charts) return lv_chart_add_series(chart, lv_palette_main(palette), LV_CHART_AXIS_PRIMARY_Y);
+	stream_chart::add_series(chart, lv_palette_main(palette));
+	return nullptr;
+}
+
+static void build(lv_obj_t* screen) {
+	current_chart = make_chart(screen, 5, 2500 * DRIVE_MOTORS / 2);
+	left_current = add_series(current_chart, LV_PALETTE_RED);
+	right_current = add_series(current_chart, LV_PALETTE_BLUE);
+	jitter_chart = make_chart(screen, 120, 5000);
+	jitter_series = add_series(jitter_chart, LV_PALETTE_GREEN);
+	for (int i = 0; i < DRIVE_MOTORS + 2; i++) {
+		temp_bars[i] = lv_bar_create(screen);
+		lv_obj_set_pos(temp_bars[i], 315 + i * 20, 5);
+		lv_obj_set_size(temp_bars[i], 14, 150);
+		lv_bar_set_range(temp_bars[i], 0, 70);
+	}
+	throughput_label = lv_label_create(screen);
+	lv_obj_set_pos(throughput_label, 315, 165);
+	lv_label_set_text(throughput_label, "Blocks/s: -");
+	jitter_label = lv_label_create(screen);
+	lv_obj_set_pos(jitter_label, 315, 190);
+	lv_label_set_text(jitter_label, "Jitter: -");
+	samples = 0;
+}
+
+static void step(int frame) {
+	if (!every(frame, DRAW_PERIOD_MS)) return;
+	int jitter = 0;
+	for (int i = 0; i < DRAW_PERIOD_MS / SAMPLE_MS; i++, samples++) {
+		double t = samples * SAMPLE_MS / 1000.0;
+		auto left = static_cast<std::int32_t>(3000 + 2500 * std::sin(t));
+		auto right = static_cast<std::int32_t>(3000 + 2500 * std::cos(t));
+		jitter = static_cast<int>(500 + 400 * std::sin(t * 7));
+		if (lv_charts) {
+			lv_chart_set_next_value(current_chart, left_current, left);
+			lv_chart_set_next_value(current_chart, right_current, right);
+			lv_chart_set_next_value(jitter_chart, jitter_series, jitter);
+		} else {
+			stream_chart::push(current_chart, {left, right});
+			stream_chart::push(jitter_chart, {jitter});
+		}
+	}
+	if (lv_charts) {
+		lv_chart_refresh(current_chart);
+		lv_chart_refresh(jitter_chart);
+	} else {
+		stream_chart::flush(current_chart);
+		stream_chart::flush(jitter_chart);
+	}
+	for (int i = 0; i < DRIVE_MOTORS + 2; i++) {
+		lv_bar_set_value(temp_bars[i], 30 + (samples / 100 + i) % 25, LV_ANIM_OFF);
+	}
+	lv_label_set_text_fmt(throughput_label, "Blocks/s: %d", samples / 50 % 4);
+	lv_label_set_text_fmt(jitter_label, "Jitter: %d us  Over: %d", jitter, 0);
+}
+
+static void build_lv_chart(lv_obj_t* screen) {
+	lv_charts = true;
+	build(screen);
+	lv_charts = false;
+}
+
+static void step_lv_chart(int frame) {
+	lv_charts = true;
+	step(frame);
+	lv_charts = false;
+}
+
+}  // namespace dashboard
+
+// An autonomous selector: pick a routine, read what it does.
+namespace selector {
+
+static const char* const routines[] = {"Left AWP", "Left 4", "Left 7", "\n", "Right AWP", "Right 4",
+                                       "Right 7", "\n", "Skills", "Ghost", "None", ""};
+static const char* const descriptions[] = {
+    "Solo win point from the left tile", "Four blocks, long goal, left", "Seven blocks, both goals, left",
+    "Solo win point from the right tile", "Four blocks, long goal, right", "Seven blocks, both goals, right",
+    "Programming skills, 60 s",           "Replays /usd/ghost.bin",        "Sits still"};
+constexpr int ROUTINES = 9;
+
+static lv_obj_t* matrix;
+static lv_obj_t* description;
+
+static void build(lv_obj_t* screen) {
+	matrix = lv_buttonmatrix_create(screen);
+	lv_buttonmatrix_set_map(matrix, routines);
+	lv_buttonmatrix_set_button_ctrl_all(matrix, LV_BUTTONMATRIX_CTRL_CHECKABLE);
+	lv_buttonmatrix_set_one_checked(matrix, true);
+	lv_obj_set_pos(matrix, 0, 0);
+	lv_obj_set_size(matrix, WIDTH, 180);
+	description = lv_label_create(screen);
+	lv_obj_set_pos(description, 10, 195);
+	lv_label_set_text(description, "");
+}
+
+static void step(int frame) {
+	if (!every(frame, 500)) return;
+	std::uint32_t choice = frame * FRAME_MS / 500 % ROUTINES;
+	lv_buttonmatrix_set_selected_button(matrix, choice);
+	lv_buttonmatrix_set_button_ctrl(matrix, choice, LV_BUTTONMATRIX_CTRL_CHECKED);
+	lv_label_set_text(description, descriptions[choice]);
+}
+
+}  // namespace selector
+
+struct Scenario {
+	const char* name;
+	void (*build)(lv_obj_t* screen);
+	void (*step)(int frame);
+};
+
+static const Scenario scenarios[] = {
+    {"llemu", llemu::build, llemu::step},
+    {"dashboard", dashboard::build, dashboard::step},
+    {"dashboard_lv_chart", dashboard::build_lv_chart, dashboard::step_lv_chart},
+    {"selector", selector::build, selector::step},
+};
+
+static void use_profile(const Profile& next) {
+	profile = &next;
+	lv_display_set_color_format(display, next.format);
+	lv_display_set_buffers(display, draw_buf, nullptr, WIDTH * DRAW_BUF_LINES * lv_color_format_get_size(next.format),
+	                       LV_DISPLAY_RENDER_MODE_PARTIAL);
+}
+
+// Per channel difference between the framebuffer and the 32-bit reference.
+static void compare_to_reference() {
+	std::uint64_t total = 0;
+	int most = 0;
+	std::uint32_t pixels_off = 0;
+	for (int i = 0; i < WIDTH * HEIGHT * 4; i += 4) {
+		int pixel_most = 0;
+		for (int c = 0; c < 3; c++) {
+			int diff = std::abs(framebuffer[i + c] - reference[i + c]);
+			total += diff;
+			pixel_most = std::max(pixel_most, diff);
+		}
+		most = std::max(most, pixel_most);
+		if (pixel_most > 0) pixels_off++;
+	}
+	std::printf("                        error vs 32-bit: %.2f avg, %d max per channel, %.1f%% of pixels differ\n",
+	            static_cast<double>(total) / (WIDTH * HEIGHT * 3), most, 100.0 * pixels_off / (WIDTH * HEIGHT));
+}
+
+static void run(const Scenario& scenario) {
+	lv_obj_t* blank = lv_screen_active();
+	lv_obj_t* screen = lv_obj_create(nullptr);
+	scenario.build(screen);
+	lv_obj_tree_walk(screen, watch, nullptr);
+	if (use_glyph_cache) glyph_cache::attach(screen);
+	lv_screen_load(screen);
+
+	// The first frame draws everything; time it on its own.
+	std::uint32_t first_us = draw_frame();
+
+	std::vector<std::uint32_t> frame_us;
+	std::uint64_t draw_tasks = 0, flushes = 0, pixels = 0;
+#if LV_USE_PERF_MONITOR
+	perf = {};
+#endif
+	screen_budget::Stats budget_start = screen_budget::stats();
+	glyph_cache::Stats glyphs_start = glyph_cache::stats();
+	bindings::Stats bound_start = bindings::stats();
+	for (int frame = 0; frame < FRAMES; frame++) {
+		scenario.step(frame);
+		frame_us.push_back(draw_frame());
+		draw_tasks += counts.draw_tasks;
+		flushes += counts.flushes;
+		pixels += counts.pixels;
+		if (!ROBOT_TIMERS) lv_timer_handler();  // lets sysmon report
+	}
+
+	std::uint64_t total_us = 0;
+	for (std::uint32_t us : frame_us) total_us += us;
+	std::sort(frame_us.begin(), frame_us.end());
+	char name[32];
+	std::snprintf(name, sizeof(name), "%s%s", scenario.name, profile->suffix);
+	std::printf("%-23s %7.2f %7.3f %7.3f %7.3f %8.0f %8.1f %9.0f %7.1f   %08x\n", name, first_us / 1000.0,
+	            total_us / 1000.0 / FRAMES, frame_us[FRAMES / 2] / 1000.0, frame_us.back() / 1000.0,
+	            total_us > 0 ? FRAMES * 1e6 / total_us : 0.0, static_cast<double>(draw_tasks) / FRAMES,
+	            static_cast<double>(pixels) / FRAMES, static_cast<double>(flushes) / FRAMES, checksum());
+#if LV_USE_PERF_MONITOR
+	std::printf("                        sysmon: %u fps, %u%% cpu, refresh %u ms, render %u ms, flush %u ms\n",
+	            static_cast<unsigned>(perf.calculated.fps), static_cast<unsigned>(perf.calculated.cpu),
+	            static_cast<unsigned>(perf.calculated.refr_avg_time),
+	            static_cast<unsigned>(perf.calculated.render_avg_time),
+	            static_cast<unsigned>(perf.calculated.flush_avg_time));
+#endif
+	if (pixel_budget > 0) {
+		screen_budget::Stats budget = screen_budget::stats();
+		std::printf("                        budget: %u areas merged, %u deferred, %u frames over, most %u pixels\n",
+		            static_cast<unsigned>(budget.merged - budget_start.merged),
+		            static_cast<unsigned>(budget.deferred - budget_start.deferred),
+		            static_cast<unsigned>(budget.over_budget - budget_start.over_budget),
+		            static_cast<unsigned>(budget.max_pixels));
+	}
+	if (use_glyph_cache) {
+		glyph_cache::Stats glyphs = glyph_cache::stats();
+		std::printf("                        glyphs: %u hits, %u decoded, %u uncached\n",
+		            static_cast<unsigned>(glyphs.hits - glyphs_start.hits),
+		            static_cast<unsigned>(glyphs.misses - glyphs_start.misses),
+		            static_cast<unsigned>(glyphs.uncached - glyphs_start.uncached));
+	}
+	if (ROBOT_TIMERS) {
+		// Nothing changes from here on; whatever the budget held back still has to show up.
+		std::uint64_t idle_pixels = 0;
+		for (int frame = 0; frame < IDLE_MS / FRAME_MS; frame++) {
+			draw_frame();
+			idle_pixels += counts.pixels;
+		}
+		std::uint32_t waiting = screen_budget::stats().waiting;
+		idle_ok &= waiting == 0;
+		std::printf("                        idle %d ms: %llu pixels drawn, %u areas still waiting%s\n", IDLE_MS,
+		            static_cast<unsigned long long>(idle_pixels), static_cast<unsigned>(waiting),
+		            waiting == 0 ? "" : ", FAILED");
+	}
+	bindings::Stats bound = bindings::stats();
+	if (bound.changes != bound_start.changes) {
+		std::printf("                        bindings: %u changes, %u applied, %u below threshold, %u rate limited\n",
+		            static_cast<unsigned>(bound.changes - bound_start.changes),
+		            static_cast<unsigned>(bound.applied - bound_start.applied),
+		            static_cast<unsigned>(bound.filtered - bound_start.filtered),
+		            static_cast<unsigned>(bound.deferred - bound_start.deferred));
+	}
+
+	if (profile->format == LV_COLOR_FORMAT_RGB565) {
+		compare_to_reference();
+	} else {
+		std::memcpy(reference, framebuffer, sizeof(framebuffer));
+	}
+
+	lv_screen_load(blank);
+	if (check_heap) {
+		kept_screens.push_back(screen);
+	} else {
+		lv_obj_delete(screen);
+	}
+}
+
+int main(int argc, char** argv) {
+	std::vector<const char*> wanted;
+	for (int i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+			trace_file = std::fopen(argv[++i], "w");
+			if (trace_file == nullptr) {
+				std::perror(argv[i]);
+				return 1;
+			}
+		} else if (std::strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+			pixel_budget = static_cast<std::uint32_t>(std::atoi(argv[++i]));
+		} else if (std::strcmp(argv[i], "--glyph-cache") == 0) {
+			use_glyph_cache = true;
+		} else if (std::strcmp(argv[i], "--rgb565") == 0) {
+			profile_count = 3;
+		} else if (std::strcmp(argv[i], "--heap") == 0) {
+			check_heap = true;
+		} else if (std::strcmp(argv[i], "--no-small-pool") == 0) {
+			lvgl_heap::set_small_pool(false);
+		} else {
+			wanted.push_back(argv[i]);
+		}
+	}
+
+	lv_init();
+	lv_tick_set_cb(millis);
+
+	// lv_init() started the profiler with its defaults; restart it on our clock.
+	lv_profiler_builtin_uninit();
+	lv_profiler_builtin_config_t config;
+	lv_profiler_builtin_config_init(&config);
+	config.tick_per_sec = 1000000;
+	config.tick_get_cb = micros;
+	config.flush_cb = write_trace;
+	lv_profiler_builtin_init(&config);
+	lv_profiler_builtin_set_enable(trace_file != nullptr);
+
+	display = lv_display_create(WIDTH, HEIGHT);
+	lv_display_set_buffers(display, draw_buf, nullptr, sizeof(draw_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+	lv_display_set_flush_cb(display, flush);
+	if (!ROBOT_TIMERS) lv_timer_pause(lv_display_get_refr_timer(display));  // only lv_refr_now() draws
+#if LV_USE_PERF_MONITOR
+	lv_subject_add_observer(&display->perf_sysmon_backend.subject, on_perf, nullptr);
+#endif
+	if (pixel_budget > 0) screen_budget::start(pixel_budget);
+
+	std::printf("%d frames of %d ms robot time, %dx%d\n\n", FRAMES, FRAME_MS, WIDTH, HEIGHT);
+	std::printf("%-23s first ms  avg ms  p50 ms  max ms      fps  tasks/f  pixels/f flush/f   checksum\n", "scenario");
+	for (const Scenario& scenario : scenarios) {
+		bool run_it = wanted.empty();
+		for (const char* name : wanted) run_it |= std::strcmp(name, scenario.name) == 0;
+		if (!run_it) continue;
+		for (int i = 0; i < profile_count; i++) {
+			use_profile(PROFILES[i]);
+			run(scenario);
+		}
+	}
+
+	bool heap_ok = true;
+	if (check_heap) {
+		std::printf("\n");
+		lvgl_heap::print();
+		lvgl_heap::Stats heap = lvgl_heap::stats();
+		heap_ok = heap.peak_bytes <= lvgl_heap::UI_HEAP_BUDGET && heap.failed == 0;
+		std::printf("heap check: %s\n", heap_ok ? "fits" : "FAILED");
+		for (lv_obj_t* screen : kept_screens) lv_obj_delete(screen);
+	}
+
+	if (trace_file != nullptr) {
+		lv_profiler_builtin_flush();
+		std::fclose(trace_file);
+	}
+	lv_deinit();
+	return heap_ok && idle_ok ? 0 : 1;
+}
@@ -0,0 +1,41 @@
+/**
+ * \file lvgl_bench_conf.h
+ *
+ * LVGL configuration for tools/lvgl_bench.cpp: the robot's
+ * include/liblvgl/lv_conf.h, plus the profiler and system monitor, which the
+ * robot build leaves off. Pass it as LV_CONF_PATH when compiling LVGL and
+ * the bench so both see the same settings.
+ *
+ * With LVGL_BENCH_ROBOT_TIMERS defined the performance monitor stays off as
+ * on the robot. LVGL only pauses its refresh timer between frames when it
+ * is off, so that build is the one that shows whether the screen catches up
+ * once nothing invalidates it any more.
+ */
+
+#ifndef LVGL_BENCH_CONF_H
+#define LVGL_BENCH_CONF_H
+
+#include "../include/liblvgl/lv_conf.h"
+
+// Frame statistics, reported through the sysmon subject instead of a label
+// so the monitor doesn't draw into the frames it is measuring.
+#define LV_USE_SYSMON 1
+#ifndef LVGL_BENCH_ROBOT_TIMERS
+#undef LV_USE_PERF_MONITOR
+#define LV_USE_PERF_MONITOR 1
+#define LV_USE_PERF_MONITOR_LOG_MODE 1
+#endif
+
+// Function-level trace of the renderer.
+#define LV_USE_PROFILER 1
+#define LV_USE_PROFILER_BUILTIN 1
+#define LV_PROFILER_INCLUDE "liblvgl/misc/lv_profiler_builtin.h"
+#define LV_PROFILER_BUILTIN_BUF_SIZE (256 * 1024)
+
+// Blend through robotcore/blend_neon.h (see there).
+#ifdef ROBOTCORE_NEON_BLEND
+#define LV_USE_DRAW_SW_ASM LV_DRAW_SW_ASM_CUSTOM
+#define LV_DRAW_SW_ASM_CUSTOM_INCLUDE "robotcore/blend_neon.h"
+#endif
+
+#endif  // LVGL_BENCH_CONF_H
@@ -0,0 +1,238 @@
+/**
+ * \file partner_link_check.cpp
+ *
+ * Checks the partner link framing (include/robotcore/partner_link.hpp) with
+ * two robots on one computer.
+ *
+ * Two Channels talk over a pair of connected LoopbackLinks, the same code the
+ * link task runs over pros::Link. Each check prints one line and the program
+ * exits non-zero if any of them failed:
+ *
+ * - round trip: every message type goes both ways and arrives intact,
+ *   including a frame that arrives split across two polls.
+ * - crc reject: a frame with one payload bit flipped is counted as bad and
+ *   not decoded, and the good frame behind it still is.
+ * - resync: line noise, stray sync bytes and a truncated frame ahead of a
+ *   good frame are skipped and the good frame decodes.
+ * - full buffer: send() returns false instead of blocking once the radio
+ *   buffer is full, and works again after the partner reads.
+ * - link error: a transport whose receive_raw() fails with PROS_ERR, or
+ *   claims more bytes than were asked for, decodes nothing and leaves the
+ *   channel working once the transport recovers.
+ *
+ * Not part of the robot build. From the project directory:
+ *
+ *   g++ -std=gnu++20 -O2 -pthread -iquote include tools/partner_link_check.cpp -o partner_link_check && \
+ *       ./partner_link_check
+ */
+
+#include "robotcore/loopback_link.hpp"
+#include "robotcore/partner_link.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+using partner::Channel;
+using partner::Inbox;
+using partner::MsgType;
+
+static int failures = 0;
+
+static void expect(bool ok, const char* check, const char* what) {
+	if (ok) return;
+	std::printf("  %s: %s\n", check, what);
+	failures++;
+}
+
+static void report(const char* check, int failures_before) {
+	std::printf("%-14s %s\n", check, failures == failures_before ? "ok" : "FAILED");
+}
+
+// A frame as Channel::send() would put it on the radio.
+static std::uint16_t frame(std::uint8_t* out, MsgType type, std::uint8_t seq, const void* payload) {
+	std::uint16_t len = partner::payload_size(type);
+	out[0] = partner::FRAME_SYNC;
+	out[1] = static_cast<std::uint8_t>(type);
+	out[2] = seq;
+	out[3] = static_cast<std::uint8_t>(len);
+	std::memcpy(out + partner::FRAME_HEADER, payload, len);
+	std::uint16_t crc = partner::crc16(out + 1, partner::FRAME_HEADER - 1 + len);
+	out[partner::FRAME_HEADER + len] = crc & 0xFF;
+	out[partner::FRAME_HEADER + len + 1] = crc >> 8;
+	return partner::FRAME_HEADER + len + partner::FRAME_CRC;
+}
+
+static bool same_pose(const partner::Pose& a, const partner::Pose& b) {
+	return a.x_mm == b.x_mm && a.y_mm == b.y_mm && a.heading_cdeg == b.heading_cdeg;
+}
+
+static void round_trip() {
+	const char* check = "round trip";
+	int before = failures;
+	LoopbackLink a, b;
+	LoopbackLink::connect(a, b);
+	Channel<LoopbackLink> robot_a(a), robot_b(b);
+	Inbox inbox_a = {}, inbox_b = {};
+
+	partner::Pose pose = {-1234, 3400, 27000};
+	partner::Intent intent = {partner::Action::score, 3, 1500};
+	partner::Claim claim = {3, 1, 4000};
+	expect(robot_a.send(MsgType::pose, pose), check, "pose did not send");
+	expect(robot_a.send(MsgType::intent, intent), check, "intent did not send");
+	expect(robot_a.send(MsgType::claim, claim), check, "claim did not send");
+	expect(robot_b.poll(inbox_b) == 3, check, "b did not decode three frames");
+	expect(same_pose(inbox_b.pose, pose), check, "pose changed on the way");
+	expect(inbox_b.intent.action == intent.action && inbox_b.intent.goal_id == intent.goal_id &&
+	           inbox_b.intent.eta_ms == intent.eta_ms,
+	       check, "intent changed on the way");
+	expect(inbox_b.claim.goal_id == claim.goal_id && inbox_b.claim.claimed == claim.claimed &&
+	           inbox_b.claim.hold_ms == claim.hold_ms,
+	       check, "claim changed on the way");
+	expect(inbox_b.pose_count == 1 && inbox_b.intent_count == 1 && inbox_b.claim_count == 1, check,
+	       "wrong message counts on b");
+	expect(inbox_b.bad_frames == 0, check, "b counted bad frames");
+
+	// The other way, with the frame arriving in two pieces.
+	partner::Pose reply = {50, -60, 9000};
+	std::uint8_t bytes[partner::MAX_FRAME];
+	std::uint16_t size = frame(bytes, MsgType::pose, 0, &reply);
+	b.transmit_raw(bytes, 5);
+	expect(robot_a.poll(inbox_a) == 0, check, "a decoded half a frame");
+	b.transmit_raw(bytes + 5, size - 5);
+	expect(robot_a.poll(inbox_a) == 1, check, "a did not decode the rest of the frame");
+	expect(same_pose(inbox_a.pose, reply) && inbox_a.pose_count == 1, check, "split pose changed on the way");
+	expect(inbox_a.bad_frames == 0, check, "a counted bad frames");
+	report(check, before);
+}
+
+static void crc_reject() {
+	const char* check = "crc reject";
+	int before = failures;
+	LoopbackLink a, b;
+	LoopbackLink::connect(a, b);
+	Channel<LoopbackLink> robot_b(b);
+	Inbox inbox = {};
+
+	partner::Pose bad = {100, 200, 300};
+	partner::Pose good = {400, 500, 600};
+	std::uint8_t bytes[2 * partner::MAX_FRAME];
+	std::uint16_t size = frame(bytes, MsgType::pose, 0, &bad);
+	bytes[partner::FRAME_HEADER] ^= 0x04;  // one bit of x_mm
+	size += frame(bytes + size, MsgType::pose, 1, &good);
+	a.transmit_raw(bytes, size);
+
+	expect(robot_b.poll(inbox) == 1, check, "expected only the good frame to decode");
+	expect(inbox.bad_frames >= 1, check, "corrupt frame was not counted");
+	expect(inbox.pose_count == 1 && same_pose(inbox.pose, good), check, "corrupt pose was accepted");
+	report(check, before);
+}
+
+static void resync() {
+	const char* check = "resync";
+	int before = failures;
+	LoopbackLink a, b;
+	LoopbackLink::connect(a, b);
+	Channel<LoopbackLink> robot_b(b);
+	Inbox inbox = {};
+
+	// Noise, a sync byte with a bad length, a sync byte with an unknown type,
+	// then the first half of a claim that never finishes.
+	const std::uint8_t garbage[] = {0x00, 0xFF, 0x13, 0x37, 0x5A,           // noise
+	                                partner::FRAME_SYNC, 1, 0, 99,          // pose with a 99 byte payload
+	                                partner::FRAME_SYNC, 42, 0, 4};         // type 42
+	std::uint8_t bytes[64];
+	std::memcpy(bytes, garbage, sizeof(garbage));
+	std::uint16_t size = sizeof(garbage);
+	partner::Claim lost = {7, 1, 100};
+	std::uint8_t cut[partner::MAX_FRAME];
+	frame(cut, MsgType::claim, 0, &lost);
+	std::memcpy(bytes + size, cut, 6);
+	size += 6;
+
+	partner::Intent intent = {partner::Action::park, 0, 250};
+	size += frame(bytes + size, MsgType::intent, 1, &intent);
+	a.transmit_raw(bytes, size);
+
+	expect(robot_b.poll(inbox) == 1, check, "good frame after garbage did not decode");
+	expect(inbox.intent_count == 1 && inbox.intent.action == intent.action && inbox.intent.eta_ms == intent.eta_ms,
+	       check, "intent changed on the way");
+	expect(inbox.claim_count == 0, check, "truncated claim was decoded");
+	expect(inbox.bad_frames > 0, check, "garbage was not counted");
+
+	// And the link keeps working afterwards.
+	partner::Pose pose = {1, 2, 3};
+	size = frame(bytes, MsgType::pose, 2, &pose);
+	a.transmit_raw(bytes, size);
+	expect(robot_b.poll(inbox) == 1 && same_pose(inbox.pose, pose), check, "next frame did not decode");
+	report(check, before);
+}
+
+static void full_buffer() {
+	const char* check = "full buffer";
+	int before = failures;
+	LoopbackLink a, b;
+	LoopbackLink::connect(a, b);
+	Channel<LoopbackLink> robot_a(a), robot_b(b);
+	Inbox inbox = {};
+
+	partner::Pose pose = {0, 0, 0};
+	int sent = 0;
+	while (robot_a.send(MsgType::pose, pose)) {
+		pose.x_mm++;
+		if (++sent > static_cast<int>(LoopbackLink::BUFFER_SIZE)) break;
+	}
+	int fits = LoopbackLink::BUFFER_SIZE / (partner::FRAME_HEADER + sizeof(pose) + partner::FRAME_CRC);
+	expect(sent == fits, check, "send() did not stop when the buffer filled");
+
+	int decoded = 0;
+	for (int i = 0; i < 2 * fits && decoded < sent; i++) decoded += robot_b.poll(inbox);
+	expect(decoded == sent && inbox.pose.x_mm == sent - 1, check, "frames lost while the buffer was full");
+	expect(robot_a.send(MsgType::pose, pose), check, "send() did not recover after the partner read");
+	report(check, before);
+}
+
+// A LoopbackLink whose receive_raw() fails the way pros::Link's can.
+class FailingLink : public LoopbackLink {
+	public:
+	std::uint32_t failure = 0;  // returned instead of a byte count while non-zero
+
+	std::uint32_t receive_raw(void* dest, std::uint16_t data_size) {
+		if (failure != 0) return failure;
+		return LoopbackLink::receive_raw(dest, data_size);
+	}
+};
+
+static void link_error() {
+	const char* check = "link error";
+	int before = failures;
+	LoopbackLink a;
+	FailingLink b;
+	LoopbackLink::connect(a, b);
+	Channel<FailingLink> robot_b(b);
+	Inbox inbox = {};
+
+	partner::Pose pose = {7, 8, 9};
+	std::uint8_t bytes[partner::MAX_FRAME];
+	std::uint16_t size = frame(bytes, MsgType::pose, 0, &pose);
+	for (std::uint32_t failure : {partner::LINK_ERR, std::uint32_t{1000}}) {
+		a.transmit_raw(bytes, size);
+		b.failure = failure;
+		for (int i = 0; i < 4; i++) expect(robot_b.poll(inbox) == 0, check, "decoded from a failed read");
+		expect(inbox.pose_count == 0 && inbox.bad_frames == 0, check, "failed read reached the decoder");
+		b.failure = 0;
+		b.clear_receive_buf();
+	}
+
+	a.transmit_raw(bytes, size);
+	expect(robot_b.poll(inbox) == 1 && same_pose(inbox.pose, pose), check, "no frame after the link recovered");
+	report(check, before);
+}
+
+int main() {
+	round_trip();
+	crc_reject();
+	resync();
+	full_buffer();
+	link_error();
+	return failures == 0 ? 0 : 1;
+}
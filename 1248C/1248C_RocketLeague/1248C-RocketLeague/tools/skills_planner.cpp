@@ -0,0 +1,431 @@
+/**
+ * \file skills_planner.cpp
+ *
+ * Finds the order to run the skills actions in, and writes it out as an
+ * autonomous function made of our drive macros.
+ *
+ * The input lists where the robot starts and every scoring action: where the
+ * robot has to be, which way it has to face, how long the action takes, what
+ * it is worth and the macro that runs it. Between two actions the robot turns,
+ * drives straight, and turns again to face the action. The search also picks
+ * whether to drive each leg forward or backward. A plan scores the points
+ * of every action that finishes inside the time limit.
+ *
+ * Leg times come from a model of the drivetrain built from robot_config
+ * (top speed from cartridge, ratio and wheel size, turn arcs from the track
+ * width) with the acceleration and deceleration below, plus the settle::stop()
+ * after each segment, just like the macros. A stop takes longer the faster
+ * the segment ended, so its time is worked out from settle's own thresholds
+ * (active braking, the still window and the timeout) and the speed the
+ * segment reached. The acceleration and deceleration are estimates, not
+ * measurements; the settle times and start speeds settle::print() logs on
+ * the robot are what to check them against. Up to 9 actions are searched exactly
+ * with branch and bound; more than that use simulated annealing. Either way
+ * the search runs on every core.
+ *
+ * Not part of the robot build. From the project directory:
+ *
+ *   g++ -std=gnu++23 -O2 -pthread -iquote include -I include -D_PROS_INCLUDE_LIBLVGL_LLEMU_HPP \
+ *       -D_PROS_INCLUDE_LIBLVGL_LLEMU_H tools/skills_planner.cpp -o skills_planner
+ *   ./skills_planner tools/skills_actions.txt > planned_skills.inc
+ *
+ * Input, one item per line, # starts a comment. Inches, degrees clockwise
+ * from the +y axis, ms:
+ *
+ *   start <x> <y> <heading>
+ *   action <name> <x> <y> <heading> <duration_ms> <points> <macro>
+ */
+
+#include "robot_setup.hpp"
+#include "robotcore/settle.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Drive = Drivetrain<robot_config>;
+
+constexpr double TIME_LIMIT_MS = 60000;
+constexpr int DRIVE_SPEED = 90;           // macro speed for straight legs, same as skeleton_auto
+constexpr int TURN_SPEED = 90;            // macro speed for turns
+constexpr double ACCEL_IN_S2 = 120;       // wheel acceleration from rest, an estimate
+constexpr double STOP_DECEL_IN_S2 = 150;  // deceleration once stop() brakes, an estimate
+constexpr int EXACT_MAX_ACTIONS = 9;
+constexpr int ANNEAL_STEPS = 2000000;
+
+struct Pose {
+	double x, y, heading;
+};
+
+struct Action {
+	std::string name;
+	Pose pose;
+	double duration_ms;
+	int points;
+	std::string macro;
+};
+
+struct Segment {
+	enum Kind { TURN, FORWARD, BACKWARD } kind;
+	double amount;  // degrees (positive is right) or inches
+	double ms;      // macro run time, not counting stop()
+};
+
+struct Plan {
+	std::vector<int> order;
+	std::vector<bool> backward;  // per leg
+	int points = -1;
+	double time_ms = 0;  // when the last counted action finished
+
+	bool better_than(const Plan& other) const {
+		return points > other.points || (points == other.points && time_ms < other.time_ms);
+	}
+};
+
+static Pose start_pose;
+static std::vector<Action> actions;
+
+static double wheel_speed(int command) { return Drive::max_speed_in_per_s * command / 127.0; }
+
+// Distance the wheels cover when driven at command for ms and then released.
+static double distance_for(int command, double ms) {
+	double v = wheel_speed(command);
+	double t = ms / 1000.0;
+	double ramp = v / ACCEL_IN_S2;
+	double end_speed = std::min(v, ACCEL_IN_S2 * t);
+	double driven = t <= ramp ? ACCEL_IN_S2 * t * t / 2 : v * t - v * ramp / 2;
+	return driven + end_speed * end_speed / (2 * STOP_DECEL_IN_S2);
+}
+
+// How long settle::stop() takes after driving at command for ms: reversing
+// the drive while it is above FAST_FRACTION, braking down to STILL_RPM, then
+// STILL_MS of standing still, in whole settle loops and at most TIMEOUT_MS.
+static double stop_ms(int command, double ms) {
+	double speed = std::min(wheel_speed(command), ACCEL_IN_S2 * ms / 1000.0);
+	double slow = settle::SLOW_FRACTION * Drive::max_speed_in_per_s;
+	double still = settle::STILL_RPM * 6 / Drive::motor_deg_per_in;
+	double braking_ms = 0;
+	if (speed > settle::FAST_FRACTION * Drive::max_speed_in_per_s) {
+		double active_ms = std::min<double>(settle::ACTIVE_MAX_MS, (speed - slow) / STOP_DECEL_IN_S2 * 1000);
+		speed -= STOP_DECEL_IN_S2 * active_ms / 1000;
+		braking_ms += active_ms;
+	}
+	if (speed > still) braking_ms += (speed - still) / STOP_DECEL_IN_S2 * 1000;
+	double total = std::ceil(braking_ms / settle::LOOP_MS) * settle::LOOP_MS + settle::STILL_MS;
+	return std::min<double>(total, settle::TIMEOUT_MS);
+}
+
+// Inverse of distance_for(), to the nearest ms.
+static double ms_for(int command, double inches) {
+	double low = 0, high = 20000;
+	for (int i = 0; i < 40; i++) {
+		double mid = (low + high) / 2;
+		(distance_for(command, mid) < inches ? low : high) = mid;
+	}
+	return std::round(high);
+}
+
+static double wrap_deg(double deg) {
+	deg = std::fmod(deg + 180.0, 360.0);
+	if (deg < 0) deg += 360.0;
+	return deg - 180.0;
+}
+
+static void add_turn(std::vector<Segment>* segments, double deg, double& ms) {
+	deg = wrap_deg(deg);
+	if (std::abs(deg) < 1) return;
+	double arc = Drive::PI * robot_config.track_width_in * std::abs(deg) / 360.0;
+	double turn_ms = ms_for(TURN_SPEED, arc);
+	ms += turn_ms + stop_ms(TURN_SPEED, turn_ms);
+	if (segments != nullptr) segments->push_back({Segment::TURN, deg, turn_ms});
+}
+
+// Time to get from pose to an action and face it, optionally filling in the segments.
+static double leg(const Pose& from, const Pose& to, bool backward, std::vector<Segment>* segments) {
+	double ms = 0;
+	double dx = to.x - from.x, dy = to.y - from.y;
+	double inches = std::hypot(dx, dy);
+	double heading = from.heading;
+	if (inches >= 0.5) {
+		double bearing = std::atan2(dx, dy) * 180.0 / Drive::PI;
+		double facing = backward ? bearing + 180.0 : bearing;
+		add_turn(segments, facing - heading, ms);
+		heading = facing;
+		double drive_ms = ms_for(DRIVE_SPEED, inches);
+		ms += drive_ms + stop_ms(DRIVE_SPEED, drive_ms);
+		if (segments != nullptr) {
+			segments->push_back({backward ? Segment::BACKWARD : Segment::FORWARD, inches, drive_ms});
+		}
+	}
+	add_turn(segments, to.heading - heading, ms);
+	return ms;
+}
+
+// Leg times only depend on the two ends and the direction, so they are worked out once.
+static std::vector<double> leg_ms;  // [from (start is n)][to][backward]
+
+static double cached_leg(int from, int to, bool backward) {
+	return leg_ms[(from * actions.size() + to) * 2 + backward];
+}
+
+static void precompute_legs() {
+	std::size_t n = actions.size();
+	leg_ms.assign((n + 1) * n * 2, 0);
+	for (std::size_t from = 0; from <= n; from++) {
+		const Pose& pose = from == n ? start_pose : actions[from].pose;
+		for (std::size_t to = 0; to < n; to++) {
+			for (int backward = 0; backward < 2; backward++) {
+				leg_ms[(from * n + to) * 2 + backward] = leg(pose, actions[to].pose, backward, nullptr);
+			}
+		}
+	}
+}
+
+static void score(Plan& plan) {
+	int at = static_cast<int>(actions.size());
+	double ms = 0;
+	plan.points = 0;
+	plan.time_ms = 0;
+	for (std::size_t i = 0; i < plan.order.size(); i++) {
+		int next = plan.order[i];
+		ms += cached_leg(at, next, plan.backward[i]) + actions[next].duration_ms;
+		if (ms > TIME_LIMIT_MS) break;
+		plan.points += actions[next].points;
+		plan.time_ms = ms;
+		at = next;
+	}
+}
+
+static std::mutex best_mutex;
+static Plan best;
+
+static void offer(const Plan& plan) {
+	std::lock_guard<std::mutex> lock(best_mutex);
+	if (plan.better_than(best)) best = plan;
+}
+
+// Quickest an action can be reached and done, from anywhere.
+static std::vector<double> min_cost;
+
+static void precompute_min_cost() {
+	int n = static_cast<int>(actions.size());
+	min_cost.assign(n, 0);
+	for (int to = 0; to < n; to++) {
+		double quickest = cached_leg(n, to, false);
+		for (int from = 0; from <= n; from++) {
+			if (from == to) continue;
+			quickest = std::min({quickest, cached_leg(from, to, false), cached_leg(from, to, true)});
+		}
+		min_cost[to] = quickest + actions[to].duration_ms;
+	}
+}
+
+// Branch and bound: depth first over which action comes next and which way
+// to drive there. A branch is dropped when even doing every action left
+// couldn't beat the best plan found so far, on points or, for the same
+// points, on time.
+class Exact {
+	public:
+	explicit Exact(int first) {
+		int n = static_cast<int>(actions.size());
+		used.assign(n, false);
+		for (int i = 0; i < n; i++) {
+			points_left += actions[i].points;
+			cost_left += min_cost[i];
+		}
+		for (int backward = 0; backward < 2; backward++) {
+			visit(n, first, backward, 0, 0);
+		}
+	}
+
+	private:
+	std::vector<bool> used;
+	std::vector<int> order;
+	std::vector<bool> backward;
+	int points_left = 0;
+	double cost_left = 0;
+	Plan local;
+
+	void visit(int at, int next, bool back, double ms, int points) {
+		ms += cached_leg(at, next, back) + actions[next].duration_ms;
+		if (ms > TIME_LIMIT_MS) return;
+		used[next] = true;
+		order.push_back(next);
+		backward.push_back(back);
+		points += actions[next].points;
+		points_left -= actions[next].points;
+		cost_left -= min_cost[next];
+
+		Plan here{order, backward, points, ms};
+		if (here.better_than(local)) {
+			local = here;
+			offer(local);
+		}
+		bool worth_going_on;
+		{
+			std::lock_guard<std::mutex> lock(best_mutex);
+			int reachable = points + points_left;
+			worth_going_on = reachable > best.points || (reachable == best.points && ms + cost_left < best.time_ms);
+		}
+		if (worth_going_on) {
+			for (int i = 0; i < static_cast<int>(actions.size()); i++) {
+				if (used[i]) continue;
+				visit(next, i, false, ms, points);
+				visit(next, i, true, ms, points);
+			}
+		}
+
+		points_left += actions[next].points;
+		cost_left += min_cost[next];
+		backward.pop_back();
+		order.pop_back();
+		used[next] = false;
+	}
+};
+
+// Simulated annealing over the order and leg directions. Moves swap two
+// actions, move one action somewhere else, or flip one leg's direction.
+static void anneal(unsigned seed) {
+	std::mt19937 rng(seed);
+	int n = static_cast<int>(actions.size());
+	Plan current;
+	current.order.resize(n);
+	for (int i = 0; i < n; i++) current.order[i] = i;
+	std::shuffle(current.order.begin(), current.order.end(), rng);
+	current.backward.assign(n, false);
+	score(current);
+	Plan local = current;
+
+	auto energy = [](const Plan& plan) { return plan.points * TIME_LIMIT_MS - plan.time_ms; };
+	std::uniform_int_distribution<int> pick(0, n - 1);
+	std::uniform_real_distribution<double> chance(0, 1);
+	double start_temp = TIME_LIMIT_MS / 10, end_temp = 1;
+
+	for (int step = 0; step < ANNEAL_STEPS; step++) {
+		double temp = start_temp * std::pow(end_temp / start_temp, static_cast<double>(step) / ANNEAL_STEPS);
+		Plan next = current;
+		int a = pick(rng), b = pick(rng);
+		switch (rng() % 3) {
+			case 0: std::swap(next.order[a], next.order[b]); break;
+			case 1: {
+				int moved = next.order[a];
+				next.order.erase(next.order.begin() + a);
+				next.order.insert(next.order.begin() + b, moved);
+				break;
+			}
+			default: next.backward[a] = !next.backward[a]; break;
+		}
+		score(next);
+		double gain = energy(next) - energy(current);
+		if (gain >= 0 || chance(rng) < std::exp(gain / temp)) {
+			current = next;
+			if (current.better_than(local)) local = current;
+		}
+	}
+	offer(local);
+}
+
+static bool load(const char* path) {
+	FILE* file = std::fopen(path, "r");
+	if (file == nullptr) return false;
+	char line[256];
+	while (std::fgets(line, sizeof(line), file) != nullptr) {
+		char* comment = std::strchr(line, '#');
+		if (comment != nullptr) *comment = '\0';
+		char kind[16], name[64], macro[128];
+		Action action;
+		if (std::sscanf(line, "%15s", kind) != 1) continue;
+		if (std::strcmp(kind, "start") == 0 &&
+		    std::sscanf(line, "%*s %lf %lf %lf", &start_pose.x, &start_pose.y, &start_pose.heading) == 3) {
+			continue;
+		}
+		if (std::strcmp(kind, "action") == 0 &&
+		    std::sscanf(line, "%*s %63s %lf %lf %lf %lf %d %127s", name, &action.pose.x, &action.pose.y,
+		                &action.pose.heading, &action.duration_ms, &action.points, macro) == 7) {
+			action.name = name;
+			action.macro = macro;
+			actions.push_back(action);
+			continue;
+		}
+		std::fprintf(stderr, "can't read: %s", line);
+		std::fclose(file);
+		return false;
+	}
+	std::fclose(file);
+	return !actions.empty();
+}
+
+static void emit(const Plan& plan, const char* source) {
+	std::printf("// Generated by tools/skills_planner from %s\n", source);
+	std::printf("// %d points, %.1f s by the drivetrain model. Re-run the planner after changing the actions.\n",
+	            plan.points, plan.time_ms / 1000.0);
+	std::printf("void planned_skills() {\n");
+	Pose at = start_pose;
+	double ms = 0;
+	for (std::size_t i = 0; i < plan.order.size(); i++) {
+		const Action& action = actions[plan.order[i]];
+		double leg_time = cached_leg(i == 0 ? static_cast<int>(actions.size()) : plan.order[i - 1], plan.order[i],
+		                             plan.backward[i]);
+		if (ms + leg_time + action.duration_ms > TIME_LIMIT_MS) break;
+		std::vector<Segment> segments;
+		leg(at, action.pose, plan.backward[i], &segments);
+		std::printf("\n\t// %s\n", action.name.c_str());
+		for (const Segment& segment : segments) {
+			switch (segment.kind) {
+				case Segment::TURN:
+					std::printf("\t%s(%d, %d);  // %.0f deg\n", segment.amount > 0 ? "turnright" : "turnleft", TURN_SPEED,
+					            static_cast<int>(segment.ms), std::abs(segment.amount));
+					break;
+				case Segment::FORWARD:
+				case Segment::BACKWARD:
+					std::printf("\t%s(%d, %d);  // %.1f in\n", segment.kind == Segment::FORWARD ? "forward" : "backward",
+					            DRIVE_SPEED, static_cast<int>(segment.ms), segment.amount);
+					break;
+			}
+			std::printf("\tstop();\n");
+		}
+		std::printf("\t%s;\n", action.macro.c_str());
+		ms += leg_time + action.duration_ms;
+		at = action.pose;
+	}
+	std::printf("}\n");
+}
+
+int main(int argc, char** argv) {
+	if (argc != 2 || !load(argv[1])) {
+		std::fprintf(stderr, "usage: skills_planner <actions file>\n");
+		return 1;
+	}
+	if (!robot_config.drive_measured) {
+		std::fprintf(stderr, "warning: the drive in robot_setup.hpp is not measured yet, leg times are guesses\n");
+	}
+	precompute_legs();
+	precompute_min_cost();
+	int n = static_cast<int>(actions.size());
+	unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+
+	std::vector<std::thread> workers;
+	if (n <= EXACT_MAX_ACTIONS) {
+		// One job per first action, handed out to the threads as they free up.
+		std::atomic<int> next_first{0};
+		for (unsigned t = 0; t < threads; t++) {
+			workers.emplace_back([&] {
+				for (int first; (first = next_first++) < n;) Exact search(first);
+			});
+		}
+	} else {
+		for (unsigned t = 0; t < threads; t++) workers.emplace_back(anneal, 1248u + t);
+	}
+	for (std::thread& worker : workers) worker.join();
+
+	std::fprintf(stderr, "%s search over %d actions on %u threads: %d points in %.1f s\n",
+	             n <= EXACT_MAX_ACTIONS ? "exact" : "annealing", n, threads, best.points, best.time_ms / 1000.0);
+	emit(best, argv[1]);
+	return 0;
+}
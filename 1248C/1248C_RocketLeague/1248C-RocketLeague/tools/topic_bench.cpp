@@ -0,0 +1,125 @@
+/**
+ * \file topic_bench.cpp
+ *
+ * Computer benchmark for Topic (include/robotcore/topic.hpp).
+ *
+ * A publisher thread stamps values with the time and publishes them; a
+ * reader thread polls with read_if_new() and records how long each value
+ * took to arrive. The same run is then repeated with a mutex-guarded
+ * variable, which is what the tasks used before. Every value also carries a
+ * checksum over its payload, so a torn read would be counted.
+ *
+ * Not part of the robot build. From the project directory:
+ *
+ *   g++ -std=gnu++20 -O2 -pthread -iquote include tools/topic_bench.cpp -o topic_bench && ./topic_bench
+ */
+
+#include "robotcore/topic.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+constexpr int MESSAGES = 20000;
+constexpr int PAYLOAD_WORDS = 6;  // about a pose or a block target
+
+struct Message {
+	std::int64_t stamp_ns;
+	std::uint32_t payload[PAYLOAD_WORDS];
+	std::uint32_t checksum;
+};
+
+static std::int64_t now_ns() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+	    .count();
+}
+
+static Message make(int i) {
+	Message message;
+	message.checksum = 0;
+	for (int w = 0; w < PAYLOAD_WORDS; w++) {
+		message.payload[w] = static_cast<std::uint32_t>(i * 2654435761u + w);
+		message.checksum ^= message.payload[w];
+	}
+	message.stamp_ns = now_ns();
+	return message;
+}
+
+static bool intact(const Message& message) {
+	std::uint32_t checksum = 0;
+	for (std::uint32_t word : message.payload) checksum ^= word;
+	return checksum == message.checksum;
+}
+
+// Mutex-guarded latest value with a version counter, like the old mailboxes.
+class Locked {
+	public:
+	void publish(const Message& message) {
+		std::lock_guard<std::mutex> lock(mutex);
+		value = message;
+		published++;
+	}
+
+	bool read_if_new(Message& out, std::uint32_t& last_version) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (published == last_version) return false;
+		out = value;
+		last_version = published;
+		return true;
+	}
+
+	private:
+	std::mutex mutex;
+	Message value{};
+	std::uint32_t published = 0;
+};
+
+template <typename Channel>
+static void run(const char* name) {
+	Channel channel;
+	std::atomic<bool> done{false};
+	std::vector<std::int64_t> latencies;
+	latencies.reserve(MESSAGES);
+	int torn = 0;
+
+	std::thread reader([&] {
+		std::uint32_t version = 0;
+		Message message;
+		while (!done.load(std::memory_order_acquire)) {
+			if (!channel.read_if_new(message, version)) {
+				std::this_thread::yield();
+				continue;
+			}
+			latencies.push_back(now_ns() - message.stamp_ns);
+			if (!intact(message)) torn++;
+		}
+	});
+
+	std::int64_t write_ns = 0;
+	for (int i = 0; i < MESSAGES; i++) {
+		Message message = make(i);
+		std::int64_t start = now_ns();
+		channel.publish(message);
+		write_ns += now_ns() - start;
+		// Sleep like a real publisher so the reader gets to run, even on one core.
+		std::this_thread::sleep_for(std::chrono::microseconds(50));
+	}
+	done.store(true, std::memory_order_release);
+	reader.join();
+
+	std::sort(latencies.begin(), latencies.end());
+	auto at = [&](double fraction) { return latencies[static_cast<std::size_t>(fraction * (latencies.size() - 1))]; };
+	std::printf("%-8s publish %6.1f ns avg | latency p50 %6lld ns  p99 %7lld ns  max %9lld ns | read %zu/%d torn %d\n",
+	            name, static_cast<double>(write_ns) / MESSAGES, static_cast<long long>(at(0.5)),
+	            static_cast<long long>(at(0.99)), static_cast<long long>(latencies.back()), latencies.size(),
+	            MESSAGES, torn);
+}
+
+int main() {
+	run<Topic<Message>>("topic");
+	run<Locked>("mutex");
+	return 0;
+}